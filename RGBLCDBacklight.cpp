@@ -0,0 +1,120 @@
+/*!
+ * @file RGBLCDBacklight.cpp
+ *
+ * Non-blocking backlight effects for the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDBacklight.h"
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+RGBLCDBacklight::RGBLCDBacklight(RGBLCDShield_FastBase &lcd)
+    : _lcd(lcd), _steps(NULL), _count(0), _index(0), _repeat(false),
+      _from(0), _shown(0xff), _due(false) {}
+
+void RGBLCDBacklight::set(uint8_t colour) {
+  _steps = NULL;
+  _from = _shown = colour;
+  _due = false;
+  _lcd.setBacklight(colour);
+}
+
+void RGBLCDBacklight::blink(uint8_t on, uint8_t off, uint16_t ms) {
+  _own[0].colour = on;
+  _own[0].fade = false;
+  _own[0].ms = ms;
+  _own[1].colour = off;
+  _own[1].fade = false;
+  _own[1].ms = ms;
+  play(_own, 2, true);
+}
+
+void RGBLCDBacklight::fade(uint8_t from, uint8_t to, uint16_t ms) {
+  _own[0].colour = to;
+  _own[0].fade = true;
+  _own[0].ms = ms;
+  _steps = _own;
+  _count = 1;
+  _index = 0;
+  _repeat = false;
+  _from = from;
+  _start = millis();
+  update();
+}
+
+void RGBLCDBacklight::play(const RGBLCDStep *steps, uint8_t count,
+                           bool repeat) {
+  _steps = count ? steps : NULL;
+  _count = count;
+  _index = 0;
+  _repeat = repeat;
+  _from = (_shown == 0xff) ? 0 : _shown;
+  _start = millis();
+  update();
+}
+
+void RGBLCDBacklight::stop() {
+  _steps = NULL;
+}
+
+void RGBLCDBacklight::update() {
+  unsigned long now = millis();
+
+  if (_steps) {
+    // Skip the steps which are over.  After a long pause at most one round
+    // is caught up, then the timing restarts.
+    for (uint8_t n = 0; now - _start >= _steps[_index].ms; n++) {
+      if (n > _count) {
+        _start = now;
+        break;
+      }
+      _start += _steps[_index].ms;
+      _from = _steps[_index].colour;
+      if (++_index == _count) {
+        _index = 0;
+        if (!_repeat) {
+          // keep the colour of the last step
+          _steps = NULL;
+          show(_from);
+          break;
+        }
+      }
+    }
+  }
+
+  if (_steps) {
+    const RGBLCDStep &step = _steps[_index];
+    uint8_t colour = step.colour;
+    if (step.fade) {
+      // The share of each period showing the new colour grows from 0 to 1
+      // over the step.
+      unsigned long t = now - _start;
+      if ((t % RGBLCD_FADE_PERIOD_MS) * step.ms >= t * RGBLCD_FADE_PERIOD_MS)
+        colour = _from;
+    }
+    show(colour);
+  }
+
+  if (_due && now - _changed >= RGBLCD_BACKLIGHT_LAG_MS) {
+    // Costs nothing if an LCD transfer carried the change meanwhile.
+    _lcd.setBacklight(_shown);
+    _due = false;
+  }
+}
+
+void RGBLCDBacklight::show(uint8_t colour) {
+  if (colour == _shown)
+    return;
+  _shown = colour;
+  _lcd.setBacklight(colour, true);
+  if (!_due) {
+    _due = true;
+    _changed = millis();
+  }
+}
@@ -0,0 +1,94 @@
+/*!
+ * @file RGBLCDBacklight.h
+ */
+
+#ifndef RGBLCDBacklight_h
+#define RGBLCDBacklight_h
+
+#include <RGBLCDShield_Fast.h>
+
+/*!
+ * @brief One step of a backlight sequence
+ */
+struct RGBLCDStep {
+  uint8_t colour; //!< Backlight colour, bit 0 red, bit 1 green, bit 2 blue
+  bool fade;      //!< Blend from the previous colour over the whole step
+  uint16_t ms;    //!< Duration of the step in milliseconds
+};
+
+/*!
+ * @brief Non-blocking backlight effects: blinking, fades and timed colour
+ * sequences, advanced by calling update() from loop().
+ *
+ * Colour changes are handed to the display lazily, so LEDs on port B ride
+ * along with the next text update.  Only if there is none for
+ * RGBLCD_BACKLIGHT_LAG_MS, update() writes them itself.  The LEDs are either
+ * on or off, a fade alternates between both colours with a changing duty
+ * cycle.
+ */
+class RGBLCDBacklight {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display whose backlight is controlled
+   */
+  explicit RGBLCDBacklight(RGBLCDShield_FastBase &lcd);
+
+  /*!
+   * @brief Stops any effect and sets a colour
+   * @param colour Backlight colour
+   */
+  void set(uint8_t colour);
+  /*!
+   * @brief Alternates between two colours
+   * @param on First colour
+   * @param off Second colour
+   * @param ms Duration of each colour in milliseconds
+   */
+  void blink(uint8_t on, uint8_t off, uint16_t ms);
+  /*!
+   * @brief Fades from one colour to another
+   * @param from Start colour
+   * @param to Final colour, kept after the fade
+   * @param ms Duration of the fade in milliseconds
+   */
+  void fade(uint8_t from, uint8_t to, uint16_t ms);
+  /*!
+   * @brief Plays a sequence of steps
+   * @param steps Steps, must stay valid while the sequence plays
+   * @param count Number of steps
+   * @param repeat true to start over after the last step, otherwise the
+   * colour of the last step is kept
+   */
+  void play(const RGBLCDStep *steps, uint8_t count, bool repeat = false);
+  /*!
+   * @brief Stops the effect, the current colour is kept
+   */
+  void stop();
+  /*!
+   * @brief Checks whether an effect is playing
+   * @return true until a sequence without repeat has ended or stop() is
+   * called
+   */
+  bool running() const { return _steps != NULL; }
+  /*!
+   * @brief Advances the effect, call this from loop()
+   */
+  void update();
+
+private:
+  void show(uint8_t colour);
+
+  RGBLCDShield_FastBase &_lcd;
+  const RGBLCDStep *_steps;
+  uint8_t _count, _index;
+  bool _repeat;
+  uint8_t _from;           // colour before the current step
+  uint8_t _shown;          // colour handed to the display
+  bool _due;               // _shown may not have reached the display yet
+  unsigned long _start;    // millis() at the start of the current step
+  unsigned long _changed;  // millis() of the last lazy change
+  RGBLCDStep _own[2];      // steps of blink() and fade()
+};
+
+#endif
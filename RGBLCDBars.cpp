@@ -0,0 +1,118 @@
+/*!
+ * @file RGBLCDBars.cpp
+ *
+ * Bar graphs for the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDBars.h"
+
+#include <string.h>
+
+/*********** horizontal */
+
+RGBLCDHBar::RGBLCDHBar(RGBLCDShield_FastBase &lcd, uint8_t col, uint8_t row,
+                       uint8_t width, uint8_t slot)
+    : _lcd(lcd), _col(col), _row(row), _slot(slot), _shown(0xff) {
+  _width = (width < 50) ? width : 50; // 250 pixels at most
+}
+
+void RGBLCDHBar::begin() {
+  uint8_t ac = _lcd.cgramBegin();
+  for (uint8_t n = 1; n <= 4; n++) {
+    // n columns from the left
+    uint8_t glyph[8];
+    memset(glyph, (0x1f << (5 - n)) & 0x1f, sizeof(glyph));
+    _lcd.cgramWrite(_slot + n - 1, glyph, false);
+  }
+  _lcd.cgramEnd(ac);
+  _shown = 0xff;
+  set(0);
+}
+
+void RGBLCDHBar::set(uint8_t pixels) {
+  uint8_t first = 0, last = _width;
+  if (pixels > 5 * _width)
+    pixels = 5 * _width;
+  if (_shown != 0xff) {
+    // only the cells between both ends can differ
+    first = ((pixels < _shown) ? pixels : _shown) / 5;
+    last = ((pixels > _shown) ? pixels : _shown) / 5 + 1;
+    if (last > _width)
+      last = _width;
+  }
+  for (uint8_t i = first; i < last; i++) {
+    uint8_t c = cell(i, pixels);
+    if (_shown == 0xff || c != cell(i, _shown))
+      _lcd.put(_col + i, _row, c);
+  }
+  _shown = pixels;
+  _lcd.putEnd();
+}
+
+uint8_t RGBLCDHBar::cell(uint8_t i, uint8_t pixels) const {
+  uint8_t base = 5 * i;
+  if (pixels >= base + 5)
+    return 0xff;
+  if (pixels <= base)
+    return ' ';
+  return _slot + pixels - base - 1;
+}
+
+/*********** vertical */
+
+RGBLCDVBar::RGBLCDVBar(RGBLCDShield_FastBase &lcd, uint8_t col, uint8_t row,
+                       uint8_t height, uint8_t slot)
+    : _lcd(lcd), _col(col), _row(row), _slot(slot), _shown(0xff),
+      _level(0xff) {
+  _height = (height <= row + 1) ? height : row + 1;
+}
+
+void RGBLCDVBar::begin() {
+  _shown = _level = 0xff;
+  set(0);
+}
+
+void RGBLCDVBar::set(uint8_t pixels) {
+  uint8_t first = 0, last = _height;
+  if (pixels > 8 * _height)
+    pixels = 8 * _height;
+  if (_shown != 0xff) {
+    first = ((pixels < _shown) ? pixels : _shown) / 8;
+    last = ((pixels > _shown) ? pixels : _shown) / 8 + 1;
+    if (last > _height)
+      last = _height;
+  }
+  for (uint8_t i = first; i < last; i++) {
+    uint8_t c = cell(i, pixels);
+    if (_shown == 0xff || c != cell(i, _shown))
+      _lcd.put(_col, _row - i, c);
+  }
+  _shown = pixels;
+
+  // The custom character shows the rows of the topmost cell, if it is
+  // partly filled.  Rewrite the rows which change.
+  if (pixels / 8 < _height) {
+    uint8_t level = pixels % 8;
+    if (_level == 0xff) {
+      _lcd.putRows(_slot, 0, 8 - level, 0x00);
+      _lcd.putRows(_slot, 8 - level, level, 0x1f);
+    } else if (level > _level) {
+      _lcd.putRows(_slot, 8 - level, level - _level, 0x1f);
+    } else if (level < _level) {
+      _lcd.putRows(_slot, 8 - _level, _level - level, 0x00);
+    }
+    _level = level;
+  }
+  _lcd.putEnd();
+}
+
+uint8_t RGBLCDVBar::cell(uint8_t i, uint8_t pixels) const {
+  uint8_t top = pixels / 8;
+  if (i < top)
+    return 0xff;
+  if (i == top)
+    return _slot;
+  return ' ';
+}
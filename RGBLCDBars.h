@@ -0,0 +1,91 @@
+/*!
+ * @file RGBLCDBars.h
+ */
+
+#ifndef RGBLCDBars_h
+#define RGBLCDBars_h
+
+#include <RGBLCDShield_Fast.h>
+
+/*!
+ * @brief Horizontal bar graph with a resolution of one pixel column
+ *
+ * Partly filled cells use four custom characters, which all horizontal bars
+ * can share.  Moving the bar by one pixel changes a single cell.
+ */
+class RGBLCDHBar {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display to draw on
+   * @param col Column of the left end
+   * @param row Row of the bar
+   * @param width Length in cells, five pixels each
+   * @param slot First of four CGRAM slots for the partly filled cells.
+   * The defaults of the bars and RGBLCDBigNumber do not overlap: big
+   * digits in 0..2, a vertical bar in 3, horizontal bars in 4..7.
+   */
+  RGBLCDHBar(RGBLCDShield_FastBase &lcd, uint8_t col, uint8_t row,
+             uint8_t width, uint8_t slot = 4);
+
+  /*!
+   * @brief Uploads the custom characters and draws an empty bar.  Call it
+   * again after something else was drawn there.
+   */
+  void begin();
+  /*!
+   * @brief Sets the length of the bar
+   * @param pixels Length in pixels, up to five per cell
+   */
+  void set(uint8_t pixels);
+
+private:
+  uint8_t cell(uint8_t i, uint8_t pixels) const;
+
+  RGBLCDShield_FastBase &_lcd;
+  uint8_t _col, _row, _width, _slot;
+  uint8_t _shown; // pixels shown, 0xff if unknown
+};
+
+/*!
+ * @brief Vertical bar graph with a resolution of one pixel row
+ *
+ * The partly filled cell uses a custom character of its own.  Moving the
+ * bar by one pixel within a cell rewrites a single row of that character.
+ */
+class RGBLCDVBar {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display to draw on
+   * @param col Column of the bar
+   * @param row Row of the bottom end
+   * @param height Height in cells, eight pixels each
+   * @param slot CGRAM slot for the partly filled cell.  The default 3 is
+   * free next to the defaults of RGBLCDHBar (4..7) and RGBLCDBigNumber
+   * (0..2), further vertical bars need slots of their own.
+   */
+  RGBLCDVBar(RGBLCDShield_FastBase &lcd, uint8_t col, uint8_t row,
+             uint8_t height, uint8_t slot = 3);
+
+  /*!
+   * @brief Draws an empty bar.  Call it again after something else was
+   * drawn there or the slot was used otherwise.
+   */
+  void begin();
+  /*!
+   * @brief Sets the height of the bar
+   * @param pixels Height in pixels, up to eight per cell
+   */
+  void set(uint8_t pixels);
+
+private:
+  uint8_t cell(uint8_t i, uint8_t pixels) const;
+
+  RGBLCDShield_FastBase &_lcd;
+  uint8_t _col, _row, _height, _slot;
+  uint8_t _shown; // pixels shown, 0xff if unknown
+  uint8_t _level; // lit rows of the custom character, 0xff if unknown
+};
+
+#endif
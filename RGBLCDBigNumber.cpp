@@ -0,0 +1,125 @@
+/*!
+ * @file RGBLCDBigNumber.cpp
+ *
+ * Large digits for the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDBigNumber.h"
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+// Custom characters of the font: upper bar, lower bar, both.
+static const uint8_t font_glyphs[3][8] PROGMEM = {
+    {0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f},
+    {0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f}};
+
+// Cells of the symbols, upper row first: blank (_), full block (X), upper
+// bar (U), lower bar (L), both bars (B).
+#define _ 0
+#define X 1
+#define U 2
+#define L 3
+#define B 4
+static const uint8_t font[12][6] PROGMEM = {
+    {X, U, X, X, L, X}, // 0
+    {U, X, _, L, X, L}, // 1
+    {B, B, X, X, L, L}, // 2
+    {B, B, X, L, L, X}, // 3
+    {X, L, X, _, _, X}, // 4
+    {X, B, B, L, L, X}, // 5
+    {X, B, B, X, L, X}, // 6
+    {U, U, X, _, _, X}, // 7
+    {X, B, X, X, L, X}, // 8
+    {X, B, X, L, L, X}, // 9
+    {_, _, _, _, _, _}, // blank
+    {L, L, L, _, _, _}  // minus
+};
+#undef _
+#undef X
+#undef U
+#undef L
+#undef B
+
+#define BIG_BLANK 10
+#define BIG_MINUS 11
+#define BIG_UNKNOWN 0xff
+
+RGBLCDBigNumber::RGBLCDBigNumber(RGBLCDShield_FastBase &lcd, uint8_t col,
+                                 uint8_t row, uint8_t digits, uint8_t slot)
+    : _lcd(lcd), _col(col), _row(row), _slot(slot) {
+  _digits = (digits < RGBLCD_BIG_DIGITS) ? digits : RGBLCD_BIG_DIGITS;
+}
+
+void RGBLCDBigNumber::begin() {
+  uint8_t ac = _lcd.cgramBegin();
+  for (uint8_t i = 0; i < 3; i++)
+    _lcd.cgramWrite(_slot + i, font_glyphs[i], true);
+  _lcd.cgramEnd(ac);
+
+  uint8_t symbols[RGBLCD_BIG_DIGITS];
+  for (uint8_t pos = 0; pos < _digits; pos++) {
+    _shown[pos] = BIG_UNKNOWN;
+    symbols[pos] = BIG_BLANK;
+  }
+  show(symbols);
+}
+
+void RGBLCDBigNumber::set(long value) {
+  uint8_t symbols[RGBLCD_BIG_DIGITS];
+  unsigned long v = (value < 0) ? -(unsigned long)value : value;
+  uint8_t pos = _digits;
+
+  do {
+    symbols[--pos] = v % 10;
+    v /= 10;
+  } while (v != 0 && pos > 0);
+  if (value < 0) {
+    if (pos > 0)
+      symbols[--pos] = BIG_MINUS;
+    else
+      v = 1;
+  }
+  if (v != 0)
+    pos = _digits; // does not fit
+  while (pos > 0)
+    symbols[--pos] = BIG_BLANK;
+  show(symbols);
+}
+
+// Sends the cells which differ from the shown symbols, row by row in one
+// transaction.
+void RGBLCDBigNumber::show(const uint8_t symbols[]) {
+  for (uint8_t r = 0; r < 2; r++) {
+    for (uint8_t pos = 0; pos < _digits; pos++) {
+      uint8_t old = _shown[pos];
+      if (symbols[pos] == old)
+        continue;
+      const uint8_t *want = font[symbols[pos]] + 3 * r;
+      const uint8_t *have = (old == BIG_UNKNOWN) ? NULL : font[old] + 3 * r;
+      uint8_t col = _col + 4 * pos;
+      for (uint8_t c = 0; c < 3; c++) {
+        uint8_t cell = pgm_read_byte(want + c);
+        if (have && cell == pgm_read_byte(have + c))
+          continue;
+        uint8_t code = _slot + cell - 2;
+        if (cell == 0)
+          code = ' ';
+        else if (cell == 1)
+          code = 0xff;
+        _lcd.put(col + c, _row + r, code);
+      }
+      if (old == BIG_UNKNOWN)
+        _lcd.put(col + 3, _row + r, ' ');
+    }
+  }
+  for (uint8_t pos = 0; pos < _digits; pos++)
+    _shown[pos] = symbols[pos];
+  _lcd.putEnd();
+}
@@ -0,0 +1,53 @@
+/*!
+ * @file RGBLCDBigNumber.h
+ */
+
+#ifndef RGBLCDBigNumber_h
+#define RGBLCDBigNumber_h
+
+#include <RGBLCDShield_Fast.h>
+
+//! Maximum number of digits of an RGBLCDBigNumber
+#define RGBLCD_BIG_DIGITS 5
+
+/*!
+ * @brief Number in large digits, two rows high and three columns wide
+ *
+ * The font needs three custom characters, so five CGRAM slots remain for
+ * other glyphs or bar graphs.  Changing the value only sends the cells
+ * which differ from what the number shows now.
+ */
+class RGBLCDBigNumber {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display to draw on
+   * @param col Column of the leftmost digit
+   * @param row Upper row of the digits
+   * @param digits Number of digits, including a minus sign, at most
+   * RGBLCD_BIG_DIGITS.  Each digit takes four columns, the last one blank.
+   * @param slot First of three CGRAM slots for the font
+   */
+  RGBLCDBigNumber(RGBLCDShield_FastBase &lcd, uint8_t col, uint8_t row,
+                  uint8_t digits, uint8_t slot = 0);
+
+  /*!
+   * @brief Uploads the font and clears the area of the number.  Call it
+   * again after something else was drawn there.
+   */
+  void begin();
+  /*!
+   * @brief Shows a value right-aligned, blank if it does not fit
+   * @param value Number to show
+   */
+  void set(long value);
+
+private:
+  void show(const uint8_t symbols[]);
+
+  RGBLCDShield_FastBase &_lcd;
+  uint8_t _col, _row, _digits, _slot;
+  uint8_t _shown[RGBLCD_BIG_DIGITS]; // symbol at each position
+};
+
+#endif
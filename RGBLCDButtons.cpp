@@ -0,0 +1,111 @@
+/*!
+ * @file RGBLCDButtons.cpp
+ *
+ * Latched, debounced button events for the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDButtons.h"
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+RGBLCDButtons::RGBLCDButtons(RGBLCDShield_FastBase &lcd)
+    : _lcd(lcd), _state(0), _raw(0), _long(0), _head(0), _count(0) {}
+
+void RGBLCDButtons::begin() {
+  MCP23017 &mcp = _lcd._i2c;
+  unsigned long now = millis();
+
+  // Interrupt on every change of a button, compared to its previous level
+  // (INTCON = 0).  INTF and INTCAP then hold the pins and the port as of the
+  // first change until INTCAP or GPIO are read.
+  mcp.writeRegister(mcp.GPINTENA, _lcd.layout().buttons);
+  // Sampling the port for the button cache would clear the capture.
+  _lcd._buttons_ttl = 0;
+  // reading the port also clears a stale capture
+  _raw = _state = _lcd.mapButtons(~mcp.readGPIOA());
+  _long = 0;
+  _changed = now;
+  for (uint8_t i = 0; i < 5; i++) {
+    // buttons held already count as pressed now, without an event
+    _pressed[i] = now;
+    _repeat[i] = RGBLCD_REPEAT_DELAY_MS;
+  }
+  _head = _count = 0;
+}
+
+uint8_t RGBLCDButtons::poll() {
+  MCP23017 &mcp = _lcd._i2c;
+  unsigned long now = millis();
+  uint8_t seen, current;
+
+  // Without a flag nothing changed since the last poll and the port need
+  // not be read.
+  if (mcp.readRegister(mcp.INTFA) & _lcd.layout().buttons) {
+    // Buttons pressed at the first change or now: a short press between two
+    // polls is seen in the capture.
+    seen = _lcd.mapButtons(~mcp.readRegister(mcp.INTCAPA));
+    current = _lcd.mapButtons(~mcp.readGPIOA());
+    seen |= current;
+    _changed = now;
+  } else {
+    seen = current = _raw;
+  }
+  _raw = current;
+
+  // Presses count at once.  Releases only once the port was stable, so
+  // bouncing contacts do not produce extra events.
+  uint8_t down = seen & ~_state;
+  uint8_t up = _state & ~current;
+  if (now - _changed < RGBLCD_DEBOUNCE_MS)
+    up = 0;
+
+  for (uint8_t i = 0; i < 5; i++) {
+    uint8_t button = 1 << i;
+    if (down & button) {
+      push(button | BUTTON_PRESS);
+      _pressed[i] = now;
+      _repeat[i] = RGBLCD_REPEAT_DELAY_MS;
+      _long &= ~button;
+    } else if (up & button) {
+      push(button | BUTTON_RELEASE);
+    } else if (_state & button) {
+      unsigned long held = now - _pressed[i];
+      if (!(_long & button) && held >= RGBLCD_LONG_PRESS_MS) {
+        push(button | BUTTON_LONG);
+        _long |= button;
+      }
+      if (RGBLCD_REPEAT_MS != 0 && held >= _repeat[i]) {
+        // one event, even if several repeats are overdue
+        push(button | BUTTON_REPEAT);
+        do
+          _repeat[i] += RGBLCD_REPEAT_MS;
+        while (held >= _repeat[i]);
+      }
+    }
+  }
+  _state = (_state | down) & ~up;
+  return _state;
+}
+
+uint8_t RGBLCDButtons::read() {
+  if (_count == 0)
+    return 0;
+  uint8_t event = _queue[_head];
+  _head = (_head + 1) % RGBLCD_EVENT_QUEUE_SIZE;
+  _count--;
+  return event;
+}
+
+void RGBLCDButtons::push(uint8_t event) {
+  // A full queue drops new events, the sketch is not reading them anyway.
+  if (_count == RGBLCD_EVENT_QUEUE_SIZE)
+    return;
+  _queue[(_head + _count) % RGBLCD_EVENT_QUEUE_SIZE] = event;
+  _count++;
+}
@@ -0,0 +1,78 @@
+/*!
+ * @file RGBLCDButtons.h
+ */
+
+#ifndef RGBLCDButtons_h
+#define RGBLCDButtons_h
+
+#include <RGBLCDShield_Fast.h>
+
+// Button events are a BUTTON_* bit combined with one of these types.
+#define BUTTON_PRESS 0x20      //!< Button went down
+#define BUTTON_RELEASE 0x40    //!< Button went up
+#define BUTTON_LONG 0x60       //!< Button held for RGBLCD_LONG_PRESS_MS
+#define BUTTON_REPEAT 0x80     //!< Button still held, auto-repeat
+#define BUTTON_EVENT_TYPE 0xe0 //!< Mask of the event type
+
+/*!
+ * @brief Latched, debounced button events
+ *
+ * The I/O expander captures the button state on the first change after each
+ * poll, so a short press between two sparse calls of poll() is not lost.
+ * Events are queued and fetched with read(), e.g.
+ * `if (ev == (BUTTON_SELECT | BUTTON_PRESS))`.
+ *
+ * Do not call readButtons() of the display while using this class, reading
+ * the port clears the captured state.  begin() disables the button cache of
+ * the display for the same reason.
+ */
+class RGBLCDButtons {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display whose buttons are read
+   */
+  explicit RGBLCDButtons(RGBLCDShield_FastBase &lcd);
+
+  /*!
+   * @brief Enables the interrupt capture of the buttons, call this after
+   * begin() of the display
+   */
+  void begin();
+  /*!
+   * @brief Reads the buttons and queues the events since the last call.
+   * Costs one register read if no button changed.
+   * @return Buttons which are pressed now, debounced
+   */
+  uint8_t poll();
+  /*!
+   * @brief Number of queued events
+   * @return Events waiting to be read
+   */
+  uint8_t available() const { return _count; }
+  /*!
+   * @brief Fetches the oldest event
+   * @return BUTTON_* bit and event type, 0 if there is none
+   */
+  uint8_t read();
+  /*!
+   * @brief Debounced state as of the last poll()
+   * @return Buttons which are pressed
+   */
+  uint8_t state() const { return _state; }
+
+private:
+  void push(uint8_t event);
+
+  RGBLCDShield_FastBase &_lcd;
+  uint8_t _state;                 // debounced buttons
+  uint8_t _raw;                   // buttons in the last sample
+  uint8_t _long;                  // held buttons which had their long press
+  unsigned long _changed;         // millis() of the last change of _raw
+  unsigned long _pressed[5];      // millis() of each press
+  unsigned long _repeat[5];       // hold time of the next repeat
+  uint8_t _queue[RGBLCD_EVENT_QUEUE_SIZE];
+  uint8_t _head, _count;
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*!
+ * @file RGBLCDGlyphs.cpp
+ *
+ * CGRAM glyph manager for the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDGlyphs.h"
+
+RGBLCDGlyphs::RGBLCDGlyphs(RGBLCDShield_FastBase &lcd,
+                           const uint8_t (*table)[8], uint8_t count)
+    : _lcd(lcd), _table(table), _count(count) {
+  reset();
+}
+
+void RGBLCDGlyphs::reset() {
+  for (uint8_t i = 0; i < 8; i++) {
+    _id[i] = 0xff;
+    _order[i] = i;
+  }
+}
+
+uint8_t RGBLCDGlyphs::get(uint8_t id) {
+  if (id >= _count)
+    return ' ';
+  uint8_t s = find(id);
+  if (s < 8) {
+    touch(s);
+    return s;
+  }
+  s = slot(id);
+  uint8_t ac = _lcd.cgramBegin();
+  _lcd.cgramWrite(s, _table[id], true);
+  _lcd.cgramEnd(ac);
+  return s;
+}
+
+void RGBLCDGlyphs::load(const uint8_t *ids, uint8_t count) {
+  // More would replace glyphs loaded by this call.
+  if (count > 8)
+    count = 8;
+  // Keep the resident ones, so the new ones do not replace them.
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t s = find(ids[i]);
+    if (s < 8)
+      touch(s);
+  }
+  uint8_t ac = 0;
+  bool open = false;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t id = ids[i];
+    if (id >= _count || find(id) < 8)
+      continue;
+    if (!open) {
+      ac = _lcd.cgramBegin();
+      open = true;
+    }
+    _lcd.cgramWrite(slot(id), _table[id], true);
+  }
+  if (open)
+    _lcd.cgramEnd(ac);
+}
+
+size_t RGBLCDGlyphs::write(uint8_t id) {
+  return _lcd.write(get(id));
+}
+
+uint8_t RGBLCDGlyphs::find(uint8_t id) const {
+  uint8_t s = 0;
+  while (s < 8 && _id[s] != id)
+    s++;
+  return s;
+}
+
+// Assigns the least recently used slot to a glyph.
+uint8_t RGBLCDGlyphs::slot(uint8_t id) {
+  uint8_t s = _order[7];
+  _id[s] = id;
+  touch(s);
+  return s;
+}
+
+void RGBLCDGlyphs::touch(uint8_t slot) {
+  uint8_t i = 0;
+  while (_order[i] != slot)
+    i++;
+  for (; i > 0; i--)
+    _order[i] = _order[i - 1];
+  _order[0] = slot;
+}
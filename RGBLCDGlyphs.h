@@ -0,0 +1,79 @@
+/*!
+ * @file RGBLCDGlyphs.h
+ */
+
+#ifndef RGBLCDGlyphs_h
+#define RGBLCDGlyphs_h
+
+#include <RGBLCDShield_Fast.h>
+
+/*!
+ * @brief More custom characters than the 8 CGRAM slots of the LCD
+ *
+ * Glyphs live in a table in PROGMEM, their index is a stable ID.  The
+ * manager keeps track of the glyphs resident in CGRAM and replaces the
+ * least recently used one when another glyph is needed.  Note that this
+ * changes all places on the display which still show the replaced glyph,
+ * so a single screen can use up to 8 different glyphs.
+ */
+class RGBLCDGlyphs {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display to manage
+   * @param table Glyphs in PROGMEM, 8 rows each
+   * @param count Number of glyphs in the table
+   */
+  RGBLCDGlyphs(RGBLCDShield_FastBase &lcd, const uint8_t (*table)[8],
+               uint8_t count);
+
+  /*!
+   * @brief Forgets which glyphs are resident, e.g. after createChar() was
+   * used directly
+   */
+  void reset();
+  /*!
+   * @brief Makes a glyph resident, uploading it if necessary
+   * @param id Index of the glyph in the table
+   * @return Character code to print, 0..7, or ' ' if the id is not in the
+   * table
+   */
+  uint8_t get(uint8_t id);
+  /*!
+   * @brief Makes several glyphs resident, all uploads in one transaction.
+   * Use it for the glyphs of a new screen.
+   * @param ids Indices of the glyphs, at most 8
+   * @param count Number of glyphs, only the first 8 are loaded
+   */
+  void load(const uint8_t *ids, uint8_t count);
+  /*!
+   * @brief Prints a glyph at the cursor
+   * @param id Index of the glyph in the table
+   * @return Number of characters written
+   */
+  size_t write(uint8_t id);
+  /*!
+   * @brief Checks if a glyph is in CGRAM
+   * @param id Index of the glyph in the table
+   * @return true if it can be printed without an upload
+   */
+  bool resident(uint8_t id) const { return find(id) < 8; }
+  /*!
+   * @brief Number of glyphs in the table
+   * @return Count given to the constructor
+   */
+  uint8_t count() const { return _count; }
+
+private:
+  uint8_t find(uint8_t id) const;
+  uint8_t slot(uint8_t id);
+  void touch(uint8_t slot);
+
+  RGBLCDShield_FastBase &_lcd;
+  const uint8_t (*_table)[8];
+  uint8_t _count;
+  uint8_t _id[8];    // glyph in each slot, 0xff if unknown
+  uint8_t _order[8]; // slots, most recently used first
+};
+
+#endif
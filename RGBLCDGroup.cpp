@@ -0,0 +1,135 @@
+/*!
+ * @file RGBLCDGroup.cpp
+ *
+ * Several RGB LCD shields on one bus.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDGroup.h"
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+RGBLCDGroup::RGBLCDGroup() : _count(0) {}
+
+bool RGBLCDGroup::add(RGBLCDShield_FastBase &lcd) {
+  if (_count >= RGBLCD_GROUP_SIZE)
+    return false;
+  _lcd[_count++] = &lcd;
+  return true;
+}
+
+void RGBLCDGroup::begin(uint8_t cols, uint8_t rows, uint8_t charsize) {
+  bool cold[RGBLCD_GROUP_SIZE];
+  bool any = false;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    cold[i] = _lcd[i]->start(cols, rows, charsize);
+    any |= cold[i];
+  }
+  if (any) {
+    // The power-on time and each step of the reset sequence are waited for
+    // once, after the step was sent to all displays.
+    delayMicroseconds(50000);
+    for (uint8_t step = 0; step < 4; step++) {
+      uint16_t wait = 0;
+      for (uint8_t i = 0; i < _count; i++)
+        if (cold[i])
+          wait = _lcd[i]->reset(step);
+      delayMicroseconds(wait);
+    }
+  }
+  for (uint8_t i = 0; i < _count; i++) {
+    // setup() ends with clear(): do not wait for it now
+    bool deferred = _lcd[i]->_deferred;
+    _lcd[i]->_deferred = true;
+    _lcd[i]->setup();
+    _lcd[i]->_deferred = deferred;
+  }
+}
+
+void RGBLCDGroup::clear() {
+  for (uint8_t i = 0; i < _count; i++) {
+    bool deferred = _lcd[i]->_deferred;
+    _lcd[i]->_deferred = true;
+    _lcd[i]->clear();
+    _lcd[i]->_deferred = deferred;
+  }
+}
+
+void RGBLCDGroup::home() {
+  for (uint8_t i = 0; i < _count; i++) {
+    bool deferred = _lcd[i]->_deferred;
+    _lcd[i]->_deferred = true;
+    _lcd[i]->home();
+    _lcd[i]->_deferred = deferred;
+  }
+}
+
+// Orders the displays: those which are ready first, then those which still
+// execute a slow command, by the time they are done.
+void RGBLCDGroup::schedule(uint8_t order[]) {
+  // one pass, so no display is listed twice when it becomes ready meanwhile
+  uint8_t head = 0, tail = _count;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_lcd[i]->isReady()) {
+      order[head++] = i;
+      continue;
+    }
+    // insertion sort into the tail, equal times in the order of the index
+    unsigned long at = _lcd[i]->_ready_at;
+    uint8_t k = --tail;
+    for (; k + 1 < _count && (long)(_lcd[order[k + 1]]->_ready_at - at) <= 0;
+         k++)
+      order[k] = order[k + 1];
+    order[k] = i;
+  }
+}
+
+void RGBLCDGroup::setCursor(uint8_t col, uint8_t row) {
+  uint8_t order[RGBLCD_GROUP_SIZE];
+  schedule(order);
+  for (uint8_t k = 0; k < _count; k++)
+    _lcd[order[k]]->setCursor(col, row);
+}
+
+void RGBLCDGroup::setBacklight(uint8_t status) {
+  // does not need the LCD
+  for (uint8_t i = 0; i < _count; i++)
+    _lcd[i]->setBacklight(status);
+}
+
+void RGBLCDGroup::flush() {
+  uint8_t order[RGBLCD_GROUP_SIZE];
+  schedule(order);
+  for (uint8_t k = 0; k < _count; k++)
+    _lcd[order[k]]->flush();
+}
+
+size_t RGBLCDGroup::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+size_t RGBLCDGroup::write(const uint8_t *buffer, size_t size) {
+  uint8_t order[RGBLCD_GROUP_SIZE];
+  size_t n = size;
+  schedule(order);
+  for (uint8_t k = 0; k < _count; k++) {
+    size_t m = _lcd[order[k]]->write(buffer, size);
+    if (m < n)
+      n = m;
+  }
+  return n;
+}
+
+void RGBLCDGroup::writeEach(const uint8_t *const buffers[], size_t size) {
+  uint8_t order[RGBLCD_GROUP_SIZE];
+  schedule(order);
+  for (uint8_t k = 0; k < _count; k++)
+    if (buffers[order[k]])
+      _lcd[order[k]]->write(buffers[order[k]], size);
+}
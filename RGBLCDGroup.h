@@ -0,0 +1,105 @@
+/*!
+ * @file RGBLCDGroup.h
+ */
+
+#ifndef RGBLCDGroup_h
+#define RGBLCDGroup_h
+
+#include <RGBLCDShield_Fast.h>
+
+//! Maximum number of shields in a group: the addresses 0..7
+#define RGBLCD_GROUP_SIZE 8
+
+/*!
+ * @brief Several RGB LCD shields on one bus, driven as a unit
+ *
+ * Printing to the group sends the same text to all displays.  Slow
+ * commands are sent to all displays first and their execution time is used
+ * to transmit to the displays which are ready already.  The busy ones
+ * follow in the order they finish.
+ */
+class RGBLCDGroup : public Print {
+public:
+  RGBLCDGroup();
+
+  /*!
+   * @brief Adds a display to the group
+   * @param lcd Display, must stay valid as long as the group is used
+   * @return false if the group is full
+   */
+  bool add(RGBLCDShield_FastBase &lcd);
+  /*!
+   * @brief Number of displays
+   * @return Number of displays added
+   */
+  uint8_t size() const { return _count; }
+  /*!
+   * @brief Access to a single display
+   * @param i Index in the order the displays were added
+   * @return The display
+   */
+  RGBLCDShield_FastBase &operator[](uint8_t i) { return *_lcd[i]; }
+
+  /*!
+   * @brief Initializes all displays, the power-on delays are shared
+   * @param cols Sets the number of columns
+   * @param rows Sets the number of rows
+   * @param charsize Sets the character size
+   */
+  void begin(uint8_t cols, uint8_t rows, uint8_t charsize = LCD_5x8DOTS);
+
+  /*!
+   * @brief Clears all displays without waiting for each of them
+   */
+  void clear();
+  /*!
+   * @brief Moves the cursor home on all displays without waiting for each
+   * of them
+   */
+  void home();
+  /*!
+   * @brief Sets the cursor on all displays
+   * @param col Column to put the cursor in
+   * @param row Row to put the cursor in
+   */
+  void setCursor(uint8_t col, uint8_t row);
+  /*!
+   * @brief Sets the backlight of all displays
+   * @param status Colour of the backlight
+   */
+  void setBacklight(uint8_t status);
+  /*!
+   * @brief Flushes the shadow framebuffers of all displays
+   */
+  virtual void flush();
+
+  /*!
+   * @brief Sends a character to all displays
+   * @param value Character to send
+   * @return 1 if all displays took it
+   */
+  virtual size_t write(uint8_t value);
+  /*!
+   * @brief Sends the same data to all displays
+   * @param buffer Data to send
+   * @param size Length of data
+   * @return Number of bytes all displays took
+   */
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  /*!
+   * @brief Sends different data to each display
+   * @param buffers One buffer per display, NULL to skip a display
+   * @param size Length of each buffer
+   */
+  void writeEach(const uint8_t *const buffers[], size_t size);
+
+  using Print::write;
+
+private:
+  void schedule(uint8_t order[]);
+
+  RGBLCDShield_FastBase *_lcd[RGBLCD_GROUP_SIZE];
+  uint8_t _count;
+};
+
+#endif
@@ -26,18 +26,41 @@
  */
 
 #include "RGBLCDShield_Fast.h"
+#include "RGBLCDGlyphs.h"
 
-#include <Wire.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
+#ifdef __AVR__
+#include <avr/eeprom.h>
 #include <avr/io.h>
 #include <compat/twi.h>
+#endif
+#ifdef RGBLCD_TWI
+// No transmit buffer, bursts are not limited.
+#include <utility/TWIMaster.h>
+#define WIRE TWIM //!< Specifies which name to use for the I2C bus
+#elif defined(RGBLCD_LINUX_I2C)
+// Not limited either, see utility/LinuxI2C.h.
+#include <utility/LinuxI2C.h>
+#define WIRE LinuxWire
+#else
+#include <Wire.h>
 #ifdef __SAM3X8E__ // Arduino Due
 #define WIRE Wire1
 #else
 #define WIRE Wire //!< Specifies which name to use for the I2C bus
 #endif
+#define BURST_LENGTH BUFFER_LENGTH //!< Size of the Wire transmit buffer
+#endif
+#include <utility/BusStats.h>
+#include <utility/Charset.h>
+#ifdef RGBLCD_STATS
+// Counts the traffic on the way, see utility/BusStats.h.
+static RGBLCDCountingBus<decltype(WIRE)> countingBus(WIRE);
+#undef WIRE
+#define WIRE countingBus
+#endif
 
 #if ARDUINO >= 100
 #include "Arduino.h"
@@ -45,6 +68,10 @@
 #include "WProgram.h"
 #endif
 
+// DDRAM address of the first column of each row.  Rows 2 and 3 continue
+// rows 0 and 1 in DDRAM.
+static const uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};
+
 // When the display powers up, it is configured as follows:
 //
 // 1. Display clear
@@ -64,81 +91,92 @@
 // can't assume that its in that state when a sketch starts (and the
 // RGBLCDShield constructor is called).
 
-RGBLCDShield_Fast::RGBLCDShield_Fast() {
+RGBLCDShield_FastBase::RGBLCDShield_FastBase(uint8_t addr) {
+  _addr = MCP23017_ADDRESS | (addr & 0x7);
   _displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
+  _gpiob = 0;
+  _burst = 0;
+  _cgram_burst = false;
+  _deferred = false;
+  _pending = false;
+  _buttons = 0;
+  _buttons_ttl = 0;
+  _ac = 0xff;
+  _wrap = false;
+  _draw_page = _show_page = 0;
+  _charset = LCD_CHARSET_RAW;
+  _utf8_need = 0;
+  _glyphs = NULL;
+  _shadow = NULL;
+#ifdef RGBLCD_TWI_ASYNC
+  _async = false;
+  _policy = LCD_QUEUE_BLOCK;
+#endif
   // we can't begin() yet :(
 }
 
 
-void RGBLCDShield_Fast::begin(uint8_t cols, uint8_t lines,
+void RGBLCDShield_FastBase::begin(uint8_t cols, uint8_t lines,
+                                  uint8_t dotsize) {
+  LCD_STATS_OP(LCD_OP_BEGIN);
+  if (start(cols, lines, dotsize)) {
+    // SEE PAGE 45/46 FOR INITIALIZATION SPECIFICATION!
+    // according to datasheet, we need at least 40ms after power rises above
+    // 2.7V before sending commands. Arduino can turn on way before 4.5V so
+    // we'll wait 50
+    delayMicroseconds(50000);
+    for (uint8_t step = 0; step < 4; step++)
+      delayMicroseconds(reset(step));
+  }
+  setup();
+}
+
+// Configures the I/O expander.  Returns true if the LCD needs the power-on
+// initialization by instruction, see reset().
+bool RGBLCDShield_FastBase::start(uint8_t cols, uint8_t lines,
                                   uint8_t dotsize) {
 #ifdef __AVR__
   // Only initialize wire interface if not yet done
   if ((TWCR & _BV(TWEN)) != _BV(TWEN))
 #endif
     WIRE.begin();
-  _i2c.begin();
+
+  // Configure all pins at once: the LCD lines on port B and the backlight
+  // are outputs, all low, i.e. the backlight is white.  The buttons on
+  // port A are inputs with pull-ups.
+  const RGBLCDLayout &L = layout();
+  uint16_t outputs = (L.rs | L.rw | L.enable | L.nibble[15]) << 8;
+  for (uint8_t i = 0; i < 3; i++)
+    outputs |= 1U << L.backlight[i];
+  bool warm = _i2c.begin(_addr & 0x7, ~outputs, L.buttons, 0);
+  _gpiob = 0;
+  _rw_state = _rs_state = LOW;
 
   // enable burst writes by disabling address increment (requires bank mode)
   _i2c.burstMode();
 
-  _i2c.pinMode(8, OUTPUT);
-  _i2c.pinMode(6, OUTPUT);
-  _i2c.pinMode(7, OUTPUT);
-  setBacklight(0x7);
-
-  _i2c.pinMode(_rw_pin, OUTPUT);
-  _i2c.pinMode(_rs_pin, OUTPUT);
-  _i2c.pinMode(_enable_pin, OUTPUT);
-  for (uint8_t i = 0; i < 4; i++)
-    _i2c.pinMode(_data_pins[i], OUTPUT);
-
-  for (uint8_t i = 0; i < 5; i++) {
-    _i2c.pinMode(_button_pins[i], INPUT);
-    _i2c.pullUp(_button_pins[i], HIGH);
-  }
-
   if (lines > 1) {
     _displayfunction |= LCD_2LINE;
   }
   _numlines = lines;
+  _numcols = cols;
   _currline = 0;
+  _draw_page = 0;
+  _ac = 0xff;
 
   // for some 1 line displays you can select a 10 pixel high font
   if ((dotsize != 0) && (lines == 1)) {
     _displayfunction |= LCD_5x10DOTS;
   }
 
-  // SEE PAGE 45/46 FOR INITIALIZATION SPECIFICATION!
-  // according to datasheet, we need at least 40ms after power rises above 2.7V
-  // before sending commands. Arduino can turn on way before 4.5V so we'll wait
-  // 50
-  delayMicroseconds(50000);
-  // Now we pull both RS and R/W low to begin commands
-  _digitalWrite(_rs_pin, LOW);
-  _digitalWrite(_enable_pin, LOW);
-  _digitalWrite(_rw_pin, LOW);
-  _rw_state = _rs_state = LOW;
-
-  // put the LCD into 4 bit mode
-  // this is according to the Hitachi HD44780 datasheet
-  // figure 24, pg 46
-
-  // we start in 8bit mode, try to set 4 bit mode
-  write4bits(0x03);
-  delayMicroseconds(4500); // wait min 4.1ms
-
-  // second try
-  write4bits(0x03);
-  delayMicroseconds(4500); // wait min 4.1ms
-
-  // third go!
-  write4bits(0x03);
-  delayMicroseconds(150);
-
-  // finally, set to 8-bit interface
-  write4bits(0x02);
+  // If the I/O expander kept its state, only the MCU was reset and the LCD
+  // probably still is in 4 bit mode.  Make sure by setting an address and
+  // reading it back.
+  return !warm || !probe();
+}
 
+// Sets up the LCD after it is in 4 bit mode.
+void RGBLCDShield_FastBase::setup() {
   // finally, set # lines, font size, etc.
   command(LCD_FUNCTIONSET | _displayfunction);
 
@@ -146,336 +184,1192 @@ void RGBLCDShield_Fast::begin(uint8_t cols, uint8_t lines,
   _displaycontrol = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
   display();
 
-  // clear it off
-  clear();
-
   // Initialize to default text direction (for roman languages)
   _displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
   // set the entry mode
   command(LCD_ENTRYMODESET | _displaymode);
+
+  // clear it off, last since this takes a long time
+  clear();
+}
+
+// Checks that the LCD is in 4 bit mode and ready for commands.
+bool RGBLCDShield_FastBase::probe() {
+  const uint8_t addr = 0x45; // valid in 1 and 2 line mode
+  command(LCD_SETDDRAMADDR | addr);
+  // The command takes 37 us, much less than reading back via I2C.
+  return readStatus() == addr;
+}
+
+// Power-on initialization by instruction, one step at a time.  Returns the
+// time in microseconds to wait before the next step.
+uint16_t RGBLCDShield_FastBase::reset(uint8_t step) {
+  // put the LCD into 4 bit mode
+  // this is according to the Hitachi HD44780 datasheet
+  // figure 24, pg 46
+  switch (step) {
+  case 0:
+    // we start in 8bit mode, try to set 4 bit mode
+    write4bits(0x03);
+    return 4500; // wait min 4.1ms
+  case 1:
+    // second try
+    write4bits(0x03);
+    return 4500; // wait min 4.1ms
+  case 2:
+    // third go!
+    write4bits(0x03);
+    return 150;
+  default:
+    // finally, set to 4-bit interface
+    write4bits(0x02);
+    return 0;
+  }
 }
 
 /********** high level commands, for the user! */
-void RGBLCDShield_Fast::clear() {
+void RGBLCDShield_FastBase::clear() {
+  LCD_STATS_OP(LCD_OP_SEND);
+  if (_shadow) {
+    memset(_shadow, ' ', _numcols * _numlines);
+    _shadow_col = _shadow_row = 0;
+    return;
+  }
   command(LCD_CLEARDISPLAY); // clear display, set cursor position to zero
-  waitBusy();                // this command takes a long time!
+  _show_page = 0;           // and display shift
+  if (_deferred) {
+    waitIdle(); // the time starts when the command has been sent
+    _ready_at = micros() + RGBLCD_CLEAR_US;
+    _pending = true;
+  } else {
+    waitBusy(); // this command takes a long time!
+  }
 }
 
-void RGBLCDShield_Fast::home() {
+void RGBLCDShield_FastBase::home() {
+  LCD_STATS_OP(LCD_OP_SEND);
+  if (_shadow) {
+    _shadow_col = _shadow_row = 0;
+    return;
+  }
   command(LCD_RETURNHOME); // set cursor position to zero
-  waitBusy();              // this command takes a long time!
+  _show_page = 0;         // and display shift
+  if (_deferred) {
+    waitIdle(); // the time starts when the command has been sent
+    _ready_at = micros() + RGBLCD_CLEAR_US;
+    _pending = true;
+  } else {
+    waitBusy(); // this command takes a long time!
+  }
+}
+
+void RGBLCDShield_FastBase::setDeferred(bool enable) {
+  _deferred = enable;
 }
 
-void RGBLCDShield_Fast::setCursor(uint8_t col, uint8_t row) {
-  int row_offsets[] = {0x00, 0x40, 0x14, 0x54};
-  if (row > _numlines) {
+bool RGBLCDShield_FastBase::isReady() {
+  if (_pending && (long)(micros() - _ready_at) >= 0)
+    _pending = false;
+  return !_pending;
+}
+
+// Waits for a deferred command before the LCD is accessed again.
+void RGBLCDShield_FastBase::settle() {
+  if (_pending) {
+    // the bus is idle anyway
+    if (buttonsStale())
+      sampleButtons();
+    long left = (long)(_ready_at - micros());
+    if (left > 0)
+      delayMicroseconds(left);
+    _pending = false;
+  }
+}
+
+void RGBLCDShield_FastBase::setCursor(uint8_t col, uint8_t row) {
+  if (row >= _numlines) {
     row = _numlines - 1; // we count rows starting w/0
   }
+  if (_shadow) {
+    _shadow_col = col;
+    _shadow_row = row;
+    return;
+  }
+
+  uint8_t addr = rowStart(row) + col;
+  if (addr != _ac)
+    command(LCD_SETDDRAMADDR | addr);
+}
+
+// DDRAM address of the first column of a row on the page drawn to.
+inline uint8_t RGBLCDShield_FastBase::rowStart(uint8_t row) const {
+  return row_offsets[row & 3] + _draw_page * _numcols;
+}
+
+/*********** page flipping */
+
+uint8_t RGBLCDShield_FastBase::pages() const {
+  // Each line has 40 columns of DDRAM.  On displays with four rows, rows 2
+  // and 3 use the columns right of rows 0 and 1.
+  return (_numlines <= 2 && _numcols <= 20) ? 2 : 1;
+}
+
+void RGBLCDShield_FastBase::drawPage(uint8_t page) {
+  if (page >= pages())
+    return;
+  _draw_page = page;
+  setCursor(0, 0);
+}
+
+void RGBLCDShield_FastBase::showPage(uint8_t page) {
+  if (page >= pages() || page == _show_page)
+    return;
+  if (page == 0) {
+    // home() also moves the cursor: put it back where drawing goes on.
+    endBurst();
+    uint8_t ac = (_ac < 0x80) ? _ac : readStatus() & 0x7f;
+    home();
+    if (ac != 0)
+      command(LCD_SETDDRAMADDR | ac);
+    return;
+  }
+  // The LCD shifts by one column per command, 37 us each, which is less
+  // than a command takes on the bus.
+  for (uint8_t i = 0; i < _numcols; i++)
+    burst(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT, LOW);
+  endBurst();
+  _show_page = page;
+}
 
-  command(LCD_SETDDRAMADDR | (col + row_offsets[row]));
+void RGBLCDShield_FastBase::flip() {
+  uint8_t shown = _show_page;
+  if (_draw_page == shown)
+    return;
+  showPage(_draw_page);
+  drawPage(shown);
 }
 
 // Turn the display on/off (quickly)
-void RGBLCDShield_Fast::noDisplay() {
+void RGBLCDShield_FastBase::noDisplay() {
   _displaycontrol &= ~LCD_DISPLAYON;
   command(LCD_DISPLAYCONTROL | _displaycontrol);
 }
-void RGBLCDShield_Fast::display() {
+void RGBLCDShield_FastBase::display() {
   _displaycontrol |= LCD_DISPLAYON;
   command(LCD_DISPLAYCONTROL | _displaycontrol);
 }
 
 // Turns the underline cursor on/off
-void RGBLCDShield_Fast::noCursor() {
+void RGBLCDShield_FastBase::noCursor() {
   _displaycontrol &= ~LCD_CURSORON;
   command(LCD_DISPLAYCONTROL | _displaycontrol);
 }
-void RGBLCDShield_Fast::cursor() {
+void RGBLCDShield_FastBase::cursor() {
   _displaycontrol |= LCD_CURSORON;
   command(LCD_DISPLAYCONTROL | _displaycontrol);
 }
 
 // Turn on and off the blinking cursor
-void RGBLCDShield_Fast::noBlink() {
+void RGBLCDShield_FastBase::noBlink() {
   _displaycontrol &= ~LCD_BLINKON;
   command(LCD_DISPLAYCONTROL | _displaycontrol);
 }
-void RGBLCDShield_Fast::blink() {
+void RGBLCDShield_FastBase::blink() {
   _displaycontrol |= LCD_BLINKON;
   command(LCD_DISPLAYCONTROL | _displaycontrol);
 }
 
 // These commands scroll the display without changing the RAM
-void RGBLCDShield_Fast::scrollDisplayLeft(void) {
+void RGBLCDShield_FastBase::scrollDisplayLeft(void) {
   command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT);
 }
-void RGBLCDShield_Fast::scrollDisplayRight(void) {
+void RGBLCDShield_FastBase::scrollDisplayRight(void) {
   command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVERIGHT);
 }
 
 // This is for text that flows Left to Right
-void RGBLCDShield_Fast::leftToRight(void) {
+void RGBLCDShield_FastBase::leftToRight(void) {
   _displaymode |= LCD_ENTRYLEFT;
   command(LCD_ENTRYMODESET | _displaymode);
 }
 // This is for text that flows Right to Left
-void RGBLCDShield_Fast::rightToLeft(void) {
+void RGBLCDShield_FastBase::rightToLeft(void) {
   _displaymode &= ~LCD_ENTRYLEFT;
   command(LCD_ENTRYMODESET | _displaymode);
 }
 
 // This will 'right justify' text from the cursor
-void RGBLCDShield_Fast::autoscroll(void) {
+void RGBLCDShield_FastBase::autoscroll(void) {
   _displaymode |= LCD_ENTRYSHIFTINCREMENT;
   command(LCD_ENTRYMODESET | _displaymode);
 }
 // This will 'left justify' text from the cursor
-void RGBLCDShield_Fast::noAutoscroll(void) {
+void RGBLCDShield_FastBase::noAutoscroll(void) {
   _displaymode &= ~LCD_ENTRYSHIFTINCREMENT;
   command(LCD_ENTRYMODESET | _displaymode);
 }
 
+// Text continues in the next row, see wrap()
+void RGBLCDShield_FastBase::lineWrap() {
+  _wrap = true;
+}
+void RGBLCDShield_FastBase::noLineWrap() {
+  _wrap = false;
+}
+
+void RGBLCDShield_FastBase::setCharset(uint8_t charset, RGBLCDGlyphs *glyphs,
+                                       const uint16_t *codesP) {
+  _charset = charset;
+  _utf8_need = 0;
+  _glyphs = codesP ? glyphs : NULL;
+  _glyph_codes = codesP;
+}
+
 // Allows us to fill the first 8 CGRAM locations
 // with custom characters
-void RGBLCDShield_Fast::createChar(uint8_t location, uint8_t charmap[]) {
+void RGBLCDShield_FastBase::createChar(uint8_t location, uint8_t charmap[]) {
+  LCD_STATS_OP(LCD_OP_CREATECHAR);
+  uint8_t ac = cgramBegin();
+  cgramWrite(location, charmap, false);
+  cgramEnd(ac);
+}
+
+void RGBLCDShield_FastBase::createCharPgm(uint8_t location, const uint8_t *charmapP) {
+  LCD_STATS_OP(LCD_OP_CREATECHAR);
+  uint8_t ac = cgramBegin();
+  cgramWrite(location, charmapP, true);
+  cgramEnd(ac);
+}
+
+// Starts a CGRAM upload.  Returns the DDRAM address to go back to, or 0xff
+// if there is no need: the shadow framebuffer sets the address itself.  A
+// burst already open, e.g. of a write() which needs a glyph, takes the
+// upload as well when the address counter is known.
+uint8_t RGBLCDShield_FastBase::cgramBegin() {
+  _cgram_burst = (_burst != 0);
+  if (_shadow)
+    return 0xff;
+  if (_ac < 0x80)
+    return _ac;
+  endBurst();
+  _cgram_burst = false;
+  return readStatus() & 0x7f; // address counter, without the busy flag
+}
+
+// Appends a glyph to the open burst.  Needs no transaction of its own.
+void RGBLCDShield_FastBase::cgramWrite(uint8_t location, const uint8_t *charmap,
+                                       bool progmem) {
   location &= 0x7; // we only have 8 locations 0-7
-  command(LCD_SETCGRAMADDR | (location << 3));
-  // Note that this somehow does not work with burst mode:
-  // write(charmap, 8);
-  for (int i = 0; i < 8; i++) {
-    write(charmap[i]);
+  burst(LCD_SETCGRAMADDR | (location << 3), LOW);
+  for (uint8_t i = 0; i < 8; i++)
+    burst(progmem ? pgm_read_byte(charmap + i) : charmap[i], HIGH);
+}
+
+// Ends a CGRAM upload and returns to the DDRAM address of cgramBegin().
+// The burst stays open if it was open before.
+void RGBLCDShield_FastBase::cgramEnd(uint8_t ac) {
+  if (ac != 0xff)
+    burst(LCD_SETDDRAMADDR | ac, LOW);
+  else
+    burst(LCD_SETDDRAMADDR, LOW); // leave CGRAM mode
+  if (!_cgram_burst)
+    endBurst();
+}
+
+// Appends a character at a given position of the draw page to the open
+// burst, or to the shadow framebuffer.  Consecutive positions need no address
+// command.
+void RGBLCDShield_FastBase::put(uint8_t col, uint8_t row, uint8_t value) {
+  if (_shadow) {
+    if (col < _numcols && row < _numlines)
+      _shadow[row * _numcols + col] = value;
+    return;
   }
-  command(LCD_SETDDRAMADDR); // unfortunately resets the location to 0,0
+  putAddr(rowStart(row) + col, value);
 }
 
-void RGBLCDShield_Fast::createCharPgm(uint8_t location, const uint8_t *charmapP) {
-  PGM_P p = reinterpret_cast<PGM_P>(charmapP);
-  location &= 0x7; // we only have 8 locations 0-7
-  command(LCD_SETCGRAMADDR | (location << 3));
-  for (int i=0; i<8; i++) {
-    byte c = pgm_read_byte(p++);
-    write(c);
+// Appends a character at a DDRAM address to the open burst.
+void RGBLCDShield_FastBase::putAddr(uint8_t addr, uint8_t value) {
+  if (addr != _ac)
+    burst(LCD_SETDDRAMADDR | addr, LOW);
+  burst(value, HIGH);
+}
+
+// Appends rows of a glyph, all with the same value, to the open burst.
+void RGBLCDShield_FastBase::putRows(uint8_t location, uint8_t first,
+                                    uint8_t count, uint8_t value) {
+  if (count == 0)
+    return;
+  burst(LCD_SETCGRAMADDR | ((location & 0x7) << 3) | first, LOW);
+  while (count--)
+    burst(value, HIGH);
+}
+
+// Ends a sequence of put() and putRows().  The LCD is back in DDRAM mode,
+// the cursor is behind the last character or at the home position.
+void RGBLCDShield_FastBase::putEnd() {
+  if (_ac == 0xfe)
+    burst(LCD_SETDDRAMADDR, LOW);
+  endBurst();
+}
+
+/*********** shadow framebuffer */
+
+void RGBLCDShield_FastBase::shadow(uint8_t *buffer) {
+  _shadow = buffer;
+  memset(_shadow, ' ', _numcols * _numlines);
+  _shadow_col = _shadow_row = 0;
+  // We do not know what is on the display, so the first flush() sends all.
+  _shadow_valid = false;
+}
+
+void RGBLCDShield_FastBase::noShadow() {
+  _shadow = NULL;
+}
+
+inline void RGBLCDShield_FastBase::shadowWrite(uint8_t value) {
+  // Text beyond the visible area is dropped.
+  if (_shadow_col >= _numcols)
+    return;
+  _shadow[_shadow_row * _numcols + _shadow_col] = value;
+  if (_displaymode & LCD_ENTRYLEFT)
+    _shadow_col++;
+  else
+    _shadow_col--;
+  if (_wrap && _shadow_col == _numcols) {
+    _shadow_col = 0;
+    if (++_shadow_row == _numlines)
+      _shadow_row = 0;
+  }
+}
+
+void RGBLCDShield_FastBase::flush() {
+  if (!flushBegin())
+    return;
+  for (uint8_t i = 0; i < 4; i++)
+    flushCells(i, 0, _numcols);
+  flushEnd();
+}
+
+// Starts a flush in pieces, false without a shadow framebuffer.
+bool RGBLCDShield_FastBase::flushBegin() {
+  _flush_stats.cells = 0;
+  _flush_stats.runs = 0;
+  _flush_stats.bytes = 0;
+  return _shadow != 0;
+}
+
+// Sends the changed cells from one column up to another of a row, the rows
+// counted in DDRAM address order: on a 20x4 display row 0 continues in row 2.
+void RGBLCDShield_FastBase::flushCells(uint8_t i, uint8_t from, uint8_t to) {
+  const uint8_t row_order[] = {0, 2, 1, 3};
+  uint8_t row = row_order[i];
+  if (row >= _numlines)
+    return;
+
+  uint8_t *want = _shadow + row * _numcols;
+  uint8_t *have = _shadow + (_numlines + row) * _numcols;
+  for (uint8_t col = from; col < to; col++) {
+    if (_shadow_valid && want[col] == have[col])
+      continue;
+    uint8_t addr = row_offsets[row] + col;
+    if (addr != _ac) {
+      // Setting the address costs 6 bytes including the RS changes,
+      // re-sending a single unchanged character only 4.
+      if (col > 0 && _ac == addr - 1) {
+        _flush_stats.bytes += burst(want[col - 1], HIGH);
+      } else {
+        _flush_stats.bytes += burst(LCD_SETDDRAMADDR | addr, LOW);
+        _flush_stats.runs++;
+      }
+    }
+    _flush_stats.bytes += burst(want[col], HIGH);
+    have[col] = want[col];
+    _flush_stats.cells++;
+  }
+}
+
+// Completes a flush once all cells went out.
+void RGBLCDShield_FastBase::flushEnd() {
+  // Leave a visible cursor where the user expects it.
+  if ((_displaycontrol & (LCD_CURSORON | LCD_BLINKON)) &&
+      _shadow_col < _numcols) {
+    uint8_t addr = row_offsets[_shadow_row] + _shadow_col;
+    if (addr != _ac) {
+      _flush_stats.bytes += burst(LCD_SETDDRAMADDR | addr, LOW);
+      _flush_stats.runs++;
+    }
   }
-  command(LCD_SETDDRAMADDR);  // unfortunately resets the location to 0,0
+  endBurst();
+  _shadow_valid = true;
 }
 
 /*********** mid level commands, for sending data/cmds */
 
-inline void RGBLCDShield_Fast::command(uint8_t value) {
+inline void RGBLCDShield_FastBase::command(uint8_t value) {
+  LCD_STATS_OP(LCD_OP_SEND);
   send(value, LOW);
 }
 
 #if ARDUINO >= 100
-inline size_t RGBLCDShield_Fast::write(uint8_t value) {
-  send(value, HIGH);
+inline size_t RGBLCDShield_FastBase::write(uint8_t value) {
+  LCD_STATS_OP(LCD_OP_SEND);
+  if (!decode(value))
+    return 0; // transmit queue full
+  endBurst();
   return 1;
 }
 #else
-inline void RGBLCDShield_Fast::write(uint8_t value) {
-  send(value, HIGH);
+inline void RGBLCDShield_FastBase::write(uint8_t value) {
+  LCD_STATS_OP(LCD_OP_SEND);
+  decode(value);
+  endBurst();
 }
 #endif
 
-size_t RGBLCDShield_Fast::write(const uint8_t *buffer, size_t size) {
-  size_t n = size;
-  uint8_t out, out1;
-  uint8_t c = 0;
+size_t RGBLCDShield_FastBase::write(const uint8_t *buffer, size_t size) {
+  LCD_STATS_OP(LCD_OP_WRITE);
+  return writeBuffer(buffer, size, false);
+}
 
-  // all LCD pins are on port B and we know all bits already
-  out = ~(_backlight >> 2) & 0x1;
-  out |= _rs_mask;  // RS==HIGH
-  out1 = out;
-
-  while (size--) {
-    byte value = *buffer++;
-
-    out = out1;
-    if (value & 0x10) out |= _data_mask[0];
-    if (value & 0x20) out |= _data_mask[1];
-    if (value & 0x40) out |= _data_mask[2];
-    if (value & 0x80) out |= _data_mask[3];
-
-    // pulse enable
-    // _i2c.writeGPIOB(out | _enable_mask);
-    // _i2c.writeGPIOB(out);
-    if (c == 0) {
-      Wire.beginTransmission(MCP23017_ADDRESS);
-      Wire.write(MCP23017_BANK_GPIOB);
-    }
-    // Changing the RS line should not be done at the same time as
-    //   setting ENABLE. So we might need another write here.
-    if (_rs_state != HIGH) {
-      _rs_state = HIGH;
-      Wire.write(out);
+size_t RGBLCDShield_FastBase::writePgm(const uint8_t *dataP, size_t len) {
+  LCD_STATS_OP(LCD_OP_WRITE);
+  return writeBuffer(dataP, len, true);
+}
+
+#if ARDUINO >= 100
+size_t RGBLCDShield_FastBase::print(const __FlashStringHelper *str) {
+  PGM_P p = reinterpret_cast<PGM_P>(str);
+  return writePgm((const uint8_t *)p, strlen_P(p));
+}
+
+size_t RGBLCDShield_FastBase::println(const __FlashStringHelper *str) {
+  size_t n = print(str);
+  return n + println();
+}
+#endif
+
+// Converts to packed BCD, two digits per byte with the lowest first, by
+// double dabble: the bits are shifted in from the top, and before each
+// shift every digit of 5 or more gets 3 added so that it carries into the
+// next digit.  AVR has no division instruction.  Returns the number of
+// digits.
+static uint8_t toBCD(uint32_t v, uint8_t bcd[5]) {
+  uint8_t bits = 32, used = 1;
+  memset(bcd, 0, 5);
+  while (bits > 0 && !(v & 0x80000000UL)) {
+    v <<= 1; // leading zeros change nothing
+    bits--;
+  }
+  for (; bits > 0; bits--) {
+    uint8_t i, carry = v >> 31;
+    v <<= 1;
+    for (i = 0; i < used; i++) {
+      uint8_t b = bcd[i];
+      if ((b & 0x0f) >= 0x05)
+        b += 0x03;
+      if (b >= 0x50)
+        b += 0x30;
+      bcd[i] = (b << 1) | carry;
+      carry = b >> 7;
     }
-    Wire.write(out | _enable_mask);
-    Wire.write(out);
-
-    out = out1;
-    if (value & 0x01) out |= _data_mask[0];
-    if (value & 0x02) out |= _data_mask[1];
-    if (value & 0x04) out |= _data_mask[2];
-    if (value & 0x08) out |= _data_mask[3];
-
-    // pulse enable
-    // _i2c.writeGPIOB(out | _enable_mask);
-    // _i2c.writeGPIOB(out);   
-    Wire.write(out | _enable_mask);
-    Wire.write(out);
-    c += 4;
-    if (c >= BUFFER_LENGTH - 4) {
-      // We only restart the transmission once the buffer is full.
-      Wire.endTransmission();
-      c = 0;
+    if (carry)
+      bcd[used++] = carry;
+  }
+  return 2 * used - (bcd[used - 1] < 0x10);
+}
+
+size_t RGBLCDShield_FastBase::printField(int32_t value, uint8_t width,
+                                         uint8_t decimals, char pad) {
+  LCD_STATS_OP(LCD_OP_WRITE);
+  uint8_t bcd[5];
+  bool neg = value < 0;
+  uint8_t digits = toBCD(neg ? -(uint32_t)value : value, bcd);
+  if (decimals > 9)
+    decimals = 9;
+  if (digits <= decimals)
+    digits = decimals + 1; // leading zero before the point
+  uint8_t len = digits + (decimals ? 1 : 0) + neg;
+
+  uint8_t i = 0;
+  if (width != 0 && len > width) {
+    while (i < width && emit('#'))
+      i++;
+    endBurst();
+    return i;
+  }
+  // digits and decimal point, without the sign
+  char text[11];
+  uint8_t t = 0;
+  while (digits--) {
+    uint8_t d = bcd[digits >> 1];
+    text[t++] = '0' + ((digits & 1) ? d >> 4 : d & 0x0f);
+    if (digits == decimals && decimals)
+      text[t++] = '.';
+  }
+  // Stops at the first character the transmit queue refuses, the ones
+  // after it would leave a gap.
+  uint8_t fill = (width > len) ? width - len : 0;
+  for (; i < fill + len; i++) {
+    char c;
+    if (neg && i == ((pad == '0') ? 0 : fill))
+      c = '-';
+    else if (i < fill + (pad == '0' && neg))
+      c = pad;
+    else
+      c = text[i - fill - neg];
+    if (!emit(c))
+      break;
+  }
+  endBurst();
+  return i;
+}
+
+// Appends a character to the open burst, or the shadow framebuffer.
+// Returns false if the transmit queue refused it.
+inline bool RGBLCDShield_FastBase::emit(uint8_t value) {
+  if (_shadow) {
+    shadowWrite(value);
+    return true;
+  }
+  uint8_t at = _ac;
+  if (!burst(value, HIGH))
+    return false;
+  if (_wrap)
+    wrap(at);
+  return true;
+}
+
+// Moves the cursor to the next row after a character has been written to
+// the last column of a row.  Where the DDRAM continues with the next row,
+// as on 40x2 displays, it already is there.
+void RGBLCDShield_FastBase::wrap(uint8_t at) {
+  if (at >= 0x80 || !(_displaymode & LCD_ENTRYLEFT) ||
+      (_displaymode & LCD_ENTRYSHIFTINCREMENT))
+    return;
+  for (uint8_t row = 0; row < _numlines; row++) {
+    if (at == rowStart(row) + _numcols - 1) {
+      uint8_t next = rowStart((row + 1 < _numlines) ? row + 1 : 0);
+      if (_ac != next)
+        burst(LCD_SETDDRAMADDR | next, LOW);
+      return;
     }
   }
-  if (c != 0) Wire.endTransmission();
+}
+
+// Decodes UTF-8 one byte at a time, see setCharset(), and appends the
+// character of each complete code point to the open burst.  The state
+// survives between calls, so a sequence may be split across them.  A
+// truncated or stray sequence prints as U+FFFD, and so does a code point
+// beyond U+FFFF, which no ROM has.
+#define UTF8_WIDE 0x80 // _utf8_need: four byte sequence
+
+bool RGBLCDShield_FastBase::decode(uint8_t value) {
+  if (_charset == LCD_CHARSET_RAW)
+    return emit(value);
+  if (value >= 0x80 && value < 0xc0) {
+    if (!_utf8_need)
+      return emit(glyph(0xfffd));
+    if (!(_utf8_need & UTF8_WIDE))
+      _utf8_cp = (_utf8_cp << 6) | (value & 0x3f);
+    if (--_utf8_need & 0x03)
+      return true;
+    _utf8_need = 0;
+    return emit(glyph(_utf8_cp));
+  }
+  if (_utf8_need) {
+    _utf8_need = 0;
+    if (!emit(glyph(0xfffd)))
+      return false;
+  }
+  if (value < 0x20)
+    return emit(value); // CGRAM characters
+  if (value < 0x80)
+    return emit(glyph(value));
+  if (value < 0xe0) {
+    _utf8_cp = value & 0x1f;
+    _utf8_need = 1;
+  } else if (value < 0xf0) {
+    _utf8_cp = value & 0x0f;
+    _utf8_need = 2;
+  } else {
+    _utf8_cp = 0xfffd;
+    _utf8_need = 3 | UTF8_WIDE;
+  }
+  return true;
+}
+
+// Character code for a code point: the ROM glyph, a glyph of the manager,
+// uploaded now if need be, or an ASCII look-alike.
+uint8_t RGBLCDShield_FastBase::glyph(uint16_t cp) {
+  uint8_t code = rgblcd_rom_code(cp, _charset);
+  if (code)
+    return code;
+  if (_glyphs) {
+    uint8_t n = _glyphs->count();
+    for (uint8_t id = 0; id < n; id++)
+      if (pgm_read_word(_glyph_codes + id) == cp)
+        return _glyphs->get(id); // uploaded within the open burst
+  }
+  code = rgblcd_ascii(cp);
+  return code ? code : '?';
+}
+
+// Sends a buffer in as few bursts as possible, reading it byte by byte
+// straight from PROGMEM if asked to.  Does not need a transaction of its
+// own for line wraps.
+size_t RGBLCDShield_FastBase::writeBuffer(const uint8_t *buffer, size_t size,
+                                          bool progmem) {
+  size_t n;
+
+  for (n = 0; n < size; n++)
+    if (!decode(progmem ? pgm_read_byte(buffer + n) : buffer[n]))
+      break; // transmit queue full
+  endBurst();
+  return n;
+}
+
+// Appends one byte for the LCD to the burst transaction on GPIOB, starting a
+// new transaction if there is none.  Returns the number of bytes this put on
+// the bus, including address and register pointer of a new transaction, or 0
+// if the transmit queue refused the byte.
+inline uint8_t RGBLCDShield_FastBase::burst(uint8_t value, uint8_t mode) {
+  const RGBLCDLayout &L = layout();
+  if (_pending)
+    settle();
+  uint8_t frame[5];
+  uint8_t len = 0;
+  uint8_t out, base;
 
+  // all LCD pins are on port B and we know all bits already
+  base = _gpiob;
+  if (mode == HIGH)
+    base |= L.rs;
   _rw_state = LOW;
+
+  out = base | L.nibble[value >> 4];
+
+  // Note: changing the RS line should not be done at the same time as
+  //   setting ENABLE. So we might need another write here.
+  bool setup = (_rs_state != mode);
+  if (setup)
+    frame[len++] = out;
+  // pulse enable
+  frame[len++] = out | L.enable;
+  frame[len++] = out;
+
+  out = base | L.nibble[value & 0x0f];
+
+  // pulse enable
+  frame[len++] = out | L.enable;
+  frame[len++] = out;
+
+#ifdef RGBLCD_TWI_ASYNC
+  if (_async) {
+    // Never drop commands, only characters.
+    uint8_t policy = (mode == HIGH) ? _policy : LCD_QUEUE_BLOCK;
+    uint8_t flags = (setup ? TWI_FRAME_SETUP : 0) |
+                    ((mode == HIGH) ? 0 : TWI_FRAME_KEEP);
+    if (!WIRE.queue(_addr, MCP23017_BANK_GPIOB, frame, len, flags,
+                    policy))
+      return 0;
+    _rs_state = mode;
+    _i2c.cacheRegister(MCP23017_BANK_GPIOB, out);
+    track(value, mode);
+    // Characters dropped later leave the address counter behind.
+    if (policy == LCD_QUEUE_DROP_OLDEST)
+      _ac = 0xff;
+    return len;
+  }
+#endif
+
+  uint8_t n = len;
+  if (_burst == 0) {
+    WIRE.beginTransmission(_addr);
+    WIRE.write(MCP23017_BANK_GPIOB);
+    _burst = 1;
+    n += 2;
+  }
+  WIRE.write(frame, len);
+  _rs_state = mode;
+  _i2c.cacheRegister(MCP23017_BANK_GPIOB, out);
+  track(value, mode);
+
+#ifdef BURST_LENGTH
+  _burst += len;
+  if (_burst > BURST_LENGTH - 5) {
+    // We only restart the transmission once the buffer is full.
+    WIRE.endTransmission();
+    _burst = 0;
+  }
+#endif
   return n;
 }
 
+// Follows the address counter of the LCD through a command or a character
+// written, so setCursor() and put() know when they need no command.
+inline void RGBLCDShield_FastBase::track(uint8_t value, uint8_t mode) {
+  if (mode == HIGH) {
+    if (_ac >= 0x80)
+      return; // unknown, or in CGRAM
+    if (!(_displayfunction & LCD_2LINE)) {
+      // one line of 80 characters
+      if (_displaymode & LCD_ENTRYLEFT)
+        _ac = (_ac == 0x4f) ? 0x00 : _ac + 1;
+      else
+        _ac = (_ac == 0x00) ? 0x4f : _ac - 1;
+    } else if (_displaymode & LCD_ENTRYLEFT) {
+      // two lines of 40 characters, at 0x00 and 0x40
+      _ac = (_ac == 0x27) ? 0x40 : (_ac == 0x67) ? 0x00 : _ac + 1;
+    } else {
+      _ac = (_ac == 0x40) ? 0x27 : (_ac == 0x00) ? 0x67 : _ac - 1;
+    }
+  } else if (value & LCD_SETDDRAMADDR) {
+    _ac = value & 0x7f;
+  } else if (value & LCD_SETCGRAMADDR) {
+    _ac = 0xfe;
+  } else if (value & LCD_FUNCTIONSET) {
+    // no change
+  } else if (value & LCD_CURSORSHIFT) {
+    if (!(value & LCD_DISPLAYMOVE))
+      _ac = 0xff; // cursor moved
+  } else if (value != 0 && value < LCD_ENTRYMODESET) {
+    _ac = 0; // clear or home
+  }
+}
+
+inline void RGBLCDShield_FastBase::endBurst() {
+  if (_burst != 0) {
+    WIRE.endTransmission();
+    _burst = 0;
+  }
+}
+
+/************ background transmit queue **********/
+
+void RGBLCDShield_FastBase::setAsync(bool enable) {
+#ifdef RGBLCD_TWI_ASYNC
+  if (!enable)
+    WIRE.waitIdle();
+  _async = enable;
+#endif
+}
+
+void RGBLCDShield_FastBase::setQueuePolicy(uint8_t policy) {
+#ifdef RGBLCD_TWI_ASYNC
+  _policy = policy;
+#endif
+}
+
+bool RGBLCDShield_FastBase::busy() {
+#ifdef RGBLCD_TWI_ASYNC
+  return WIRE.busy();
+#else
+  return false;
+#endif
+}
+
+uint8_t RGBLCDShield_FastBase::pending() {
+#ifdef RGBLCD_TWI_ASYNC
+  return WIRE.pending();
+#else
+  return 0;
+#endif
+}
+
+void RGBLCDShield_FastBase::waitIdle() {
+#ifdef RGBLCD_TWI_ASYNC
+  WIRE.waitIdle();
+#endif
+}
+
+
+/************ I2C clock calibration **********/
+
+// I2C clock the bus runs at, as far as we can tell, otherwise the given one.
+static uint32_t busClock(uint32_t clock) {
+#if defined(TWBR) && defined(F_CPU)
+  // SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS)
+  return F_CPU / (16 + 2UL * TWBR * (1 << 2 * (TWSR & 0x3)));
+#else
+  return clock;
+#endif
+}
+
+uint32_t RGBLCDShield_FastBase::calibrateClock(uint32_t max, int eeprom) {
+  uint32_t good = 0;
+  bool failed = false;
+
+#if defined(TWBR) && defined(F_CPU)
+  // fastest clock of the TWI hardware, with TWBR = 0
+  if (max > F_CPU / 16)
+    max = F_CPU / 16;
+#endif
+  endBurst();
+  waitIdle();
+  for (uint32_t hz = 100000; hz <= max && !failed; hz += 100000) {
+    WIRE.setClock(hz);
+    failed = !verify();
+    if (!failed)
+      good = busClock(hz); // TWBR only approximates the step
+  }
+
+  uint32_t clock = good * (100 - RGBLCD_CALIBRATE_MARGIN) / 100;
+  if (clock < 100000)
+    clock = 100000;
+  WIRE.setClock(clock);
+  clock = busClock(clock);
+  if (failed) {
+    // The failed step may have garbled the configuration of the expander
+    // and the nibble phase of the LCD.
+    _i2c.resync();
+    _rs_state = _rw_state = LOW;
+    for (uint8_t step = 0; step < 4; step++)
+      delayMicroseconds(reset(step));
+  }
+  setup();
+  if (good == 0)
+    return 0;
+
+#ifdef __AVR__
+  if (eeprom >= 0) {
+    uint8_t rec[5];
+    memcpy(rec, &clock, 4);
+    rec[4] = rec[0] ^ rec[1] ^ rec[2] ^ rec[3] ^ 0x5a;
+    eeprom_update_block(rec, (void *)(uintptr_t)eeprom, sizeof(rec));
+  }
+#endif
+  return clock;
+}
+
+uint32_t RGBLCDShield_FastBase::restoreClock(int eeprom) {
+#ifdef __AVR__
+  uint8_t rec[5];
+  eeprom_read_block(rec, (const void *)(uintptr_t)eeprom, sizeof(rec));
+  if (rec[4] != (rec[0] ^ rec[1] ^ rec[2] ^ rec[3] ^ 0x5a))
+    return 0; // never calibrated
+  uint32_t clock;
+  memcpy(&clock, rec, 4);
+  if (clock < 100000)
+    return 0;
+  endBurst();
+  waitIdle();
+  WIRE.setClock(clock);
+  return clock;
+#else
+  return 0;
+#endif
+}
+
+// Checks that the expander and the LCD work at the current clock: writes
+// patterns with every nibble value to DDRAM and CGRAM, reads them back and
+// checks the address counter.
+bool RGBLCDShield_FastBase::verify() {
+  uint8_t want[16], have[16];
+
+  // In burst mode, both addresses hold IOCON with BANK and SEQOP set.
+  uint8_t iocon = _i2c.readRegister(MCP23017_BANK_IOCONA);
+  if ((iocon & (0x80 | 0x20)) != (0x80 | 0x20) ||
+      _i2c.readRegister(MCP23017_BANK_IOCONB) != iocon)
+    return false;
+
+  for (uint8_t round = 0; round < 2; round++) {
+    for (uint8_t i = 0; i < 16; i++)
+      want[i] = ((i << 4) | (15 - i)) ^ (round ? 0xff : 0x00);
+
+    burst(LCD_SETDDRAMADDR, LOW);
+    for (uint8_t i = 0; i < 16; i++)
+      burst(want[i], HIGH);
+    endBurst();
+    if (!verifyStatus(16))
+      return false;
+    command(LCD_SETDDRAMADDR);
+    readLCD(HIGH, have, 16);
+    if (memcmp(want, have, 16) != 0)
+      return false;
+
+    // Custom character 0 has 5 bits per row.
+    burst(LCD_SETCGRAMADDR, LOW);
+    for (uint8_t i = 0; i < 8; i++)
+      burst(want[i] & 0x1f, HIGH);
+    endBurst();
+    if (!verifyStatus(8))
+      return false;
+    command(LCD_SETCGRAMADDR);
+    readLCD(HIGH, have, 8);
+    for (uint8_t i = 0; i < 8; i++)
+      if ((have[i] & 0x1f) != (want[i] & 0x1f))
+        return false;
+  }
+  return true;
+}
+
+// Checks the address counter after a write.  The LCD may still be busy
+// with the last character, but not for longer than one more read.
+bool RGBLCDShield_FastBase::verifyStatus(uint8_t ac) {
+  uint8_t status = readStatus();
+  if (status & 0x80)
+    status = readStatus();
+  return status == ac;
+}
+
+/************ bus statistics **********/
+
+#ifdef RGBLCD_STATS
+RGBLCDBusStats rgblcd_bus_stats[LCD_OPS];
+uint8_t rgblcd_bus_op = LCD_OP_OTHER;
+#endif
+
+void RGBLCDShield_FastBase::busStats(uint8_t op, RGBLCDBusStats &stats,
+                                     uint32_t clock) {
+  memset(&stats, 0, sizeof(stats));
+#ifdef RGBLCD_STATS
+  if (op >= LCD_OPS)
+    return;
+  noInterrupts();
+  stats = rgblcd_bus_stats[op];
+  interrupts();
+  if (clock == 0)
+    clock = busClock(RGBLCD_I2C_CLOCK);
+  stats.us = stats.bits * (1000000.0 / clock);
+#endif
+}
+
+void RGBLCDShield_FastBase::resetBusStats() {
+#ifdef RGBLCD_STATS
+  noInterrupts();
+  memset(rgblcd_bus_stats, 0, sizeof(rgblcd_bus_stats));
+  interrupts();
+#endif
+}
 
 /************ low level data pushing commands **********/
 
 // little wrapper for i/o writes
-void RGBLCDShield_Fast::_digitalWrite(uint8_t p, uint8_t d) {
+void RGBLCDShield_FastBase::_digitalWrite(uint8_t p, uint8_t d) {
   // an i2c command
   _i2c.digitalWrite(p, d);
 }
 
 // Allows to set the backlight, if the LCD backpack is used
-void RGBLCDShield_Fast::setBacklight(uint8_t status) {
-  // check if i2c or SPI
-  _i2c.digitalWrite(8, ~(status >> 2) & 0x1);
-  _i2c.digitalWrite(7, ~(status >> 1) & 0x1);
-  _i2c.digitalWrite(6, ~status & 0x1);
-  _backlight = status;
+void RGBLCDShield_FastBase::setBacklight(uint8_t status, bool lazy) {
+  LCD_STATS_OP(LCD_OP_BACKLIGHT);
+  const RGBLCDLayout &L = layout();
+  // The LEDs are active low.  Remember the ones on port B since every LCD
+  // transfer rewrites that port.
+  uint16_t mask = 0, value = 0;
+  for (uint8_t i = 0; i < 3; i++) {
+    mask |= 1U << L.backlight[i];
+    if (!((status >> i) & 0x1))
+      value |= 1U << L.backlight[i];
+  }
+  _gpiob = value >> 8;
+  // Port B is left to the next LCD transfer, which writes _gpiob anyway.
+  if (lazy)
+    mask &= 0xff;
+  // at most one write per port, none if nothing changes
+  _i2c.updateGPIOAB(mask, value);
+}
+
+void RGBLCDShield_FastBase::resync() {
+  endBurst();
+  waitIdle();
+  _i2c.resync();
 }
 
 // little wrapper for i/o directions
-void RGBLCDShield_Fast::_pinMode(uint8_t p, uint8_t d) {
+void RGBLCDShield_FastBase::_pinMode(uint8_t p, uint8_t d) {
   // an i2c command
   _i2c.pinMode(p, d);
 }
 
-int RGBLCDShield_Fast::waitBusy() {
+int RGBLCDShield_FastBase::waitBusy() {
+  const RGBLCDLayout &L = layout();
   int n = 0;
 
+  settle();
+
   // Set data lines as input
-  // for (i = 0; i < 4; i++)
-    // pinMode(_data_pins[i], INPUT);
-  _i2c.writeRegister(MCP23017_BANK_IODIRB, (_data_mask[0] | _data_mask[1] | _data_mask[2] | _data_mask[3]));
+  _i2c.writeRegister(MCP23017_BANK_IODIRB, L.nibble[15]);
 
-  Wire.beginTransmission(MCP23017_ADDRESS);
-  Wire.write(MCP23017_BANK_GPIOB);
+  WIRE.beginTransmission(_addr);
+  WIRE.write(MCP23017_BANK_GPIOB);
 
-  const uint8_t out = _rw_mask;
+  const uint8_t out = _gpiob | L.rw;
 
   // According to the HD44780 timing diagram, RW needs to be set at least 40 ns before enable.
   // Hence, we need another write.
-  Wire.write(out);
+  WIRE.write(out);
 
   uint8_t busy;
   do {
-    Wire.write(out | _enable_mask);
-    Wire.endTransmission();
+    WIRE.write(out | L.enable);
+    WIRE.endTransmission();
 
     // Burst mode. No need to set address again.
-    Wire.requestFrom(MCP23017_ADDRESS, 1);
-    busy = Wire.read() & _data_mask[3];
+    WIRE.requestFrom(_addr, (uint8_t)1);
+    busy = WIRE.read() & L.nibble[8]; // D7
+
+    // Use the time the LCD needs anyway.  Only the next write sets the
+    // register pointer back to GPIOB.
+    if (busy && buttonsStale())
+      sampleButtons();
 
-    Wire.beginTransmission(MCP23017_ADDRESS);
-    Wire.write(MCP23017_BANK_GPIOB);
-    Wire.write(out);
-    Wire.write(out | _enable_mask);
-    Wire.write(out);
+    WIRE.beginTransmission(_addr);
+    WIRE.write(MCP23017_BANK_GPIOB);
+    WIRE.write(out);
+    WIRE.write(out | L.enable);
+    WIRE.write(out);
 
     n++;
   } while (busy);
 
   // Set RW LOW again.
-  Wire.write(0x00);
-  Wire.endTransmission();
+  WIRE.write(_gpiob);
+  WIRE.endTransmission();
+  _i2c.cacheRegister(MCP23017_BANK_GPIOB, _gpiob);
 
   // Note that RW is now always LOW at the end of any method.
   _rs_state = _rw_state = LOW;
 
   // Set all data lines as output again
-  // for (i = 0; i < 4; i++)
-    // pinMode(_data_pins[i], OUTPUT);
   _i2c.writeRegister(MCP23017_BANK_IODIRB, 0);
 
+  LCD_STATS_POLLS(n);
   return n;
 }
 
-// write either command or data, with automatic 4/8-bit selection
-void RGBLCDShield_Fast::send(uint8_t value, uint8_t mode) {
-  uint8_t out, out1;
+// Reads busy flag and address counter.
+uint8_t RGBLCDShield_FastBase::readStatus() {
+  uint8_t status;
+  readLCD(LOW, &status, 1);
+  return status;
+}
 
-  // all LCD pins are on port B and we know all bits already
-  out = ~(_backlight >> 2) & 0x1;
+// Reads n bytes from the LCD: the status with mode LOW, otherwise data from
+// DDRAM or CGRAM at the address counter, which advances.
+void RGBLCDShield_FastBase::readLCD(uint8_t mode, uint8_t *data, uint8_t n) {
+  const RGBLCDLayout &L = layout();
+  uint8_t out = _gpiob | L.rw;
   if (mode == HIGH)
-    out |= _rs_mask;
-  _rw_state = LOW;
+    out |= L.rs;
 
-  out1 = out;
-  if (value & 0x10) out |= _data_mask[0];
-  if (value & 0x20) out |= _data_mask[1];
-  if (value & 0x40) out |= _data_mask[2];
-  if (value & 0x80) out |= _data_mask[3];
+  settle();
 
-  // pulse enable
-  // _i2c.writeGPIOB(out | _enable_mask);
-  // _i2c.writeGPIOB(out);
-  Wire.beginTransmission(MCP23017_ADDRESS);
-  Wire.write(MCP23017_BANK_GPIOB);
-  // Note: changing the RS line should not be done at the same time as
-  //   setting ENABLE. So we might need another write here.
-  if (_rs_state != mode)
-    Wire.write(out);
-  _rs_state = mode;
-  Wire.write(out | _enable_mask);
-  Wire.write(out);
+  // Set data lines as input
+  _i2c.writeRegister(MCP23017_BANK_IODIRB, L.nibble[15]);
+
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t value = 0;
+    for (uint8_t h = 0; h < 2; h++) {
+      // RW and RS need to be set before enable, see waitBusy().  This also
+      // ends the enable pulse of the previous nibble.
+      WIRE.beginTransmission(_addr);
+      WIRE.write(MCP23017_BANK_GPIOB);
+      WIRE.write(out);
+      WIRE.write(out | L.enable);
+      WIRE.endTransmission();
+
+      // Burst mode. No need to set address again.
+      WIRE.requestFrom(_addr, (uint8_t)1);
+      uint8_t pins = WIRE.read();
+      value <<= 4;
+      for (uint8_t b = 0; b < 4; b++)
+        if (pins & L.nibble[1 << b])
+          value |= 1 << b;
+    }
+    data[i] = value;
+    if (i + 1 < n) {
+      // End the pulse: the LCD advances the address counter and needs the
+      // execution time of a data read before the next one.
+      WIRE.beginTransmission(_addr);
+      WIRE.write(MCP23017_BANK_GPIOB);
+      WIRE.write(out);
+      WIRE.endTransmission();
+      delayMicroseconds(40);
+    }
+  }
 
-  out = out1;
-  if (value & 0x01) out |= _data_mask[0];
-  if (value & 0x02) out |= _data_mask[1];
-  if (value & 0x04) out |= _data_mask[2];
-  if (value & 0x08) out |= _data_mask[3];
+  WIRE.beginTransmission(_addr);
+  WIRE.write(MCP23017_BANK_GPIOB);
+  WIRE.write(out);
+  WIRE.write(_gpiob);
+  WIRE.endTransmission();
+  _i2c.cacheRegister(MCP23017_BANK_GPIOB, _gpiob);
+  _rs_state = _rw_state = LOW;
+  if (mode == HIGH)
+    _ac = 0xff; // advanced, maybe in CGRAM
 
-  // pulse enable
-  // _i2c.writeGPIOB(out | _enable_mask);
-  // _i2c.writeGPIOB(out);
-  Wire.write(out | _enable_mask);
-  Wire.write(out);
-  Wire.endTransmission();
+  // Set all data lines as output again
+  _i2c.writeRegister(MCP23017_BANK_IODIRB, 0);
+}
+
+// write either command or data, with automatic 4/8-bit selection
+void RGBLCDShield_FastBase::send(uint8_t value, uint8_t mode) {
+  burst(value, mode);
+  endBurst();
 }
 
-void RGBLCDShield_Fast::write4bits(uint8_t value) {
+void RGBLCDShield_FastBase::write4bits(uint8_t value) {
+  const RGBLCDLayout &L = layout();
   uint8_t out;
 
+  settle();
+
   // all LCD pins are on port B and we know them all already
-  out = ~(_backlight >> 2) & 0x1;
+  out = _gpiob | L.nibble[value & 0x0f];
   if (_rs_state == HIGH)
-    out |= _rs_mask;
+    out |= L.rs;
   if (_rw_state == HIGH)
-    out |= _rw_mask;
-  for (int i = 0; i < 4; i++) {
-    if ((value >> i) & 0x1)
-      out |= _data_mask[i];
-  }
+    out |= L.rw;
 
   // Note: changing the RS line should not be done at the same time as
   //   setting ENABLE.
   // But this method is only ever called with RS=LOW already, so we're OK.
 
   // pulse enable
-  _i2c.writeGPIOB(out | _enable_mask);
+  _i2c.writeGPIOB(out | L.enable);
   _i2c.writeGPIOB(out);
+  _ac = 0xff; // reset by instruction, the address counter is unknown
+}
+
+uint8_t RGBLCDShield_FastBase::readButtons(void) {
+  LCD_STATS_OP(LCD_OP_BUTTONS);
+  if (_buttons_ttl != 0 && millis() - _buttons_at < _buttons_ttl)
+    return _buttons;
+  return sampleButtons();
 }
 
-uint8_t RGBLCDShield_Fast::readButtons(void) {
+void RGBLCDShield_FastBase::setButtonCache(uint16_t ms) {
+  _buttons_ttl = ms;
+  _buttons_at = millis() - ms; // stale
+}
+
+unsigned long RGBLCDShield_FastBase::buttonAge() {
+  return millis() - _buttons_at;
+}
+
+// Checks if waiting for the LCD should be used to refresh the button cache:
+// at half its lifetime, so readButtons() rarely finds it expired.
+inline bool RGBLCDShield_FastBase::buttonsStale() {
+  return _buttons_ttl != 0 && millis() - _buttons_at >= _buttons_ttl / 2;
+}
+
+uint8_t RGBLCDShield_FastBase::sampleButtons() {
   // all buttons are on port A: read all in one go
-  return (~_i2c.readGPIOA() & 0x1f);
+  _buttons = mapButtons(~_i2c.readGPIOA());
+  _buttons_at = millis();
+  return _buttons;
+}
+
+// Converts a mask of port A pins into BUTTON_* bits.
+uint8_t RGBLCDShield_FastBase::mapButtons(uint8_t pins) {
+  const RGBLCDLayout &L = layout();
+  if (L.buttons_direct)
+    return pins & 0x1f;
+  uint8_t buttons = 0;
+  for (uint8_t i = 0; i < 5; i++)
+    if (pins & RGBLCDLayout::bit(L.button_pins[i]))
+      buttons |= 1 << i;
+  return buttons;
 }
@@ -6,6 +6,7 @@
 #define RGBLCDShield_Fast_h
 
 #include "Print.h"
+#include <RGBLCDShield_Fast_config.h>
 #include <inttypes.h>
 #include <utility/MCP23017.h>
 
@@ -57,16 +58,150 @@
 #define BUTTON_RIGHT 0x02  //!< Right button
 #define BUTTON_SELECT 0x01 //!< Select button
 
+// policies for a full transmit queue, see RGBLCDShield_Fast::setQueuePolicy()
+#define LCD_QUEUE_BLOCK 0       //!< Wait until there is room
+#define LCD_QUEUE_DROP_OLDEST 1 //!< Discard the oldest characters
+#define LCD_QUEUE_SHORT 2       //!< Stop writing, write() returns less
+
+// operations counted by the bus statistics, see RGBLCDShield_Fast::busStats()
+#define LCD_OP_SEND 0       //!< Commands and write() of a single character
+#define LCD_OP_WRITE 1      //!< write() of a buffer, i.e. print()
+#define LCD_OP_CREATECHAR 2 //!< createChar() and createCharPgm()
+#define LCD_OP_BUTTONS 3    //!< readButtons()
+#define LCD_OP_BACKLIGHT 4  //!< setBacklight()
+#define LCD_OP_BEGIN 5      //!< begin()
+#define LCD_OP_OTHER 6      //!< everything else, e.g. flush() and helpers
+#define LCD_OPS 7           //!< Number of operations
+
+// character ROMs, see RGBLCDShield_Fast::setCharset()
+#define LCD_CHARSET_RAW 0 //!< Bytes go to the LCD unchanged
+#define LCD_CHARSET_A00 1 //!< UTF-8 for the Japanese ROM
+#define LCD_CHARSET_A02 2 //!< UTF-8 for the European ROM
+
+//! Size of the buffer required by RGBLCDShield_Fast::shadow()
+#define LCD_SHADOW_SIZE(cols, rows) (2 * (cols) * (rows))
+
 #ifdef ARDUINO_ARCH_MEGAAVR
 using namespace arduino; //!< MEGA AVR architecture uses the arduino namespace
 #endif                   //!< but AVR arch does not
 
 /*!
- * @brief Base class for RGB LCD shield
+ * @brief Statistics of the last shadow framebuffer flush
+ */
+struct RGBLCDFlushStats {
+  uint8_t cells;  //!< Number of cells that changed
+  uint8_t runs;   //!< Number of DDRAM address commands sent
+  uint16_t bytes; //!< Number of bytes sent on the I2C bus
+};
+
+/*!
+ * @brief I2C traffic of an operation, see RGBLCDShield_Fast::busStats()
+ */
+struct RGBLCDBusStats {
+  uint32_t calls;        //!< Number of calls of the operation
+  uint32_t transactions; //!< I2C transactions, each ended by a STOP
+  uint32_t starts;       //!< START conditions, repeated ones included
+  uint32_t written;      //!< Bytes written, without the address bytes
+  uint32_t read;         //!< Bytes read, without the address bytes
+  uint32_t polls;        //!< Busy flag polls in waitBusy()
+  uint32_t bits;         //!< Bus clock cycles including START, STOP and ACK
+  uint32_t us;           //!< Estimated bus time in microseconds
+};
+
+/*!
+ * @brief Pin layout of an MCP23017 LCD backpack: the HD44780 lines (RS, RW,
+ * E, D4..D7) have to be on port B, the buttons on port A.
+ *
+ * This is the default layout, the Adafruit RGB LCD shield.  Other backpacks
+ * provide a struct with the same members to RGBLCDShield_FastT.
+ */
+struct AdafruitShieldLayout {
+  static constexpr uint8_t rs = 15;     //!< LOW: command.  HIGH: character.
+  static constexpr uint8_t rw = 14;     //!< LOW: write to LCD.  HIGH: read.
+  static constexpr uint8_t enable = 13; //!< activated by a HIGH pulse.
+  static constexpr uint8_t d4 = 12;     //!< data line 4
+  static constexpr uint8_t d5 = 11;     //!< data line 5
+  static constexpr uint8_t d6 = 10;     //!< data line 6
+  static constexpr uint8_t d7 = 9;      //!< data line 7
+  static constexpr uint8_t red = 6;     //!< red backlight, active low
+  static constexpr uint8_t green = 7;   //!< green backlight, active low
+  static constexpr uint8_t blue = 8;    //!< blue backlight, active low
+  static constexpr uint8_t select = 0;  //!< select button, active low
+  static constexpr uint8_t right = 1;   //!< right button, active low
+  static constexpr uint8_t down = 2;    //!< down button, active low
+  static constexpr uint8_t up = 3;      //!< up button, active low
+  static constexpr uint8_t left = 4;    //!< left button, active low
+};
+
+/*!
+ * @brief Pin masks and nibble encoding of a layout, computed at compile time
+ */
+struct RGBLCDLayout {
+  uint8_t nibble[16]; //!< GPIOB data lines for each nibble value
+  uint8_t rs;         //!< GPIOB mask of RS
+  uint8_t rw;         //!< GPIOB mask of RW
+  uint8_t enable;     //!< GPIOB mask of E
+  uint8_t buttons;    //!< GPIOA mask of all buttons
+  uint8_t backlight[3];   //!< Pins of the red, green and blue backlight
+  uint8_t button_pins[5]; //!< Pins of the buttons in BUTTON_* bit order
+  bool buttons_direct;    //!< Buttons are on GPA0..4 in BUTTON_* bit order
+
+  /*!
+   * @brief Mask of a pin within its port
+   */
+  static constexpr uint8_t bit(uint8_t pin) { return uint8_t(1 << (pin % 8)); }
+
+  /*!
+   * @brief GPIOB data lines for a nibble
+   */
+  template <class L> static constexpr uint8_t encode(uint8_t n) {
+    return uint8_t(((n & 1) ? bit(L::d4) : 0) | ((n & 2) ? bit(L::d5) : 0) |
+                   ((n & 4) ? bit(L::d6) : 0) | ((n & 8) ? bit(L::d7) : 0));
+  }
+
+  /*!
+   * @brief Derives the masks and the nibble table of a layout
+   */
+  template <class L> static constexpr RGBLCDLayout make() {
+    return RGBLCDLayout{
+        {encode<L>(0), encode<L>(1), encode<L>(2), encode<L>(3), encode<L>(4),
+         encode<L>(5), encode<L>(6), encode<L>(7), encode<L>(8), encode<L>(9),
+         encode<L>(10), encode<L>(11), encode<L>(12), encode<L>(13),
+         encode<L>(14), encode<L>(15)},
+        bit(L::rs),
+        bit(L::rw),
+        bit(L::enable),
+        uint8_t(bit(L::select) | bit(L::right) | bit(L::down) | bit(L::up) |
+                bit(L::left)),
+        {L::red, L::green, L::blue},
+        {L::select, L::right, L::down, L::up, L::left},
+        L::select == 0 && L::right == 1 && L::down == 2 && L::up == 3 &&
+            L::left == 4};
+  }
+};
+
+class RGBLCDGlyphs;
+
+/*!
+ * @brief Base class for RGB LCD shield, use RGBLCDShield_Fast or
+ * RGBLCDShield_FastT
  */
-class RGBLCDShield_Fast : public Print {
+class RGBLCDShield_FastBase : public Print {
+  friend class RGBLCDGroup;
+  friend class RGBLCDButtons;
+  friend class RGBLCDGlyphs;
+  friend class RGBLCDBigNumber;
+  friend class RGBLCDHBar;
+  friend class RGBLCDVBar;
+  friend class RGBLCDTicker;
+  friend class RGBLCDTerminal;
+
 public:
-  RGBLCDShield_Fast();
+  /*!
+   * @brief Constructor
+   * @param addr Address of the shield as set by the A0..A2 jumpers, 0..7
+   */
+  explicit RGBLCDShield_FastBase(uint8_t addr = 0);
 
   /*!
    * @brief RGB LCD shield constructor
@@ -105,6 +240,20 @@ public:
    */
   void home();
 
+  /*!
+   * @brief Selects whether clear() and home() wait for the LCD. In deferred
+   * mode they return at once and the next transfer which needs the LCD
+   * waits for the remainder of the execution time.  Buttons and backlight
+   * can be used meanwhile.
+   * @param enable true to defer the wait
+   */
+  void setDeferred(bool enable);
+  /*!
+   * @brief Checks if a deferred clear() or home() has completed
+   * @return true if the LCD accepts the next command without waiting
+   */
+  bool isReady();
+
   /*!
    * @brief High-level command to turn the display off
    */
@@ -153,28 +302,143 @@ public:
    * @brief High-level command to 'left justify' text from cursor
    */
   void noAutoscroll();
+  /*!
+   * @brief Makes text continue at the start of the next row when it reaches
+   * the end of a row, and in the first row after the last.  The address
+   * command goes into the burst of the text.  Only for text flowing left to
+   * right without autoscroll.
+   */
+  void lineWrap();
+  /*!
+   * @brief Lets text beyond the end of a row run into the invisible part of
+   * the DDRAM, the default
+   */
+  void noLineWrap();
+  /*!
+   * @brief Makes write() and print() decode UTF-8 and print each code point
+   * with its glyph in the character ROM.  Sequences may be split across
+   * calls.  Code points without a ROM glyph take a glyph of the manager if
+   * it has one, uploaded on demand, then an ASCII look-alike, e.g. 'e' for
+   * U+00E9, and '?' as the last resort.  Bytes 0..31 still print the CGRAM
+   * characters.
+   * @param charset LCD_CHARSET_A00 or LCD_CHARSET_A02 for the ROM of the
+   * display, LCD_CHARSET_RAW to send bytes unchanged, the default
+   * @param glyphs Glyph manager of this display for code points without a
+   * ROM glyph, or NULL
+   * @param codesP Code point of each glyph of the manager, in PROGMEM
+   */
+  void setCharset(uint8_t charset, RGBLCDGlyphs *glyphs = NULL,
+                  const uint16_t *codesP = NULL);
+
+  /*!
+   * @brief Number of pages, see drawPage()
+   * @return 2 on displays with up to two rows of up to 20 columns, 1
+   * otherwise
+   */
+  uint8_t pages() const;
+  /*!
+   * @brief Selects the page setCursor() and print() go to, as well as the
+   * bars and big numbers, and moves the cursor to its top left corner.
+   * Page 1 lies in the DDRAM columns right of the visible ones, so it can
+   * be drawn while page 0 is shown.  Not with the shadow framebuffer.
+   * @param page 0 or 1, see pages()
+   */
+  void drawPage(uint8_t page);
+  /*!
+   * @brief Shows a page with the display shift.  Page 1 takes one shift
+   * command per column, all in one burst, page 0 a home() and an address
+   * command which puts the cursor back.  The cursor stays on the page drawn
+   * to.  Other display shifts, e.g. scrollDisplayLeft(), are not accounted
+   * for.
+   * @param page 0 or 1, see pages()
+   */
+  void showPage(uint8_t page);
+  /*!
+   * @brief Shows the page drawn to and draws to the one shown before, i.e.
+   * swaps front and back buffer
+   */
+  void flip();
+
+  /*!
+   * @brief Enables the shadow framebuffer. From now on, print(), write(),
+   * setCursor(), clear() and home() only update the copy in RAM and flush()
+   * transfers the cells which changed.
+   * @param buffer Buffer of LCD_SHADOW_SIZE(cols, rows) bytes, must stay
+   * valid until noShadow() is called
+   */
+  void shadow(uint8_t *buffer);
+  /*!
+   * @brief Disables the shadow framebuffer, writes go to the display again
+   */
+  void noShadow();
+  /*!
+   * @brief Sends all cells of the shadow framebuffer which differ from the
+   * display content in a single I2C burst
+   */
+  virtual void flush();
+  /*!
+   * @brief Statistics of the last flush()
+   * @return Changed cells, address commands and bytes sent
+   */
+  const RGBLCDFlushStats &flushStats() const { return _flush_stats; }
+
+  /*!
+   * @brief Enables the background transmit queue. Writes then return as soon
+   * as the data is queued and the TWI interrupt sends it. Requires
+   * RGBLCD_TWI_ASYNC, see RGBLCDShield_Fast_config.h, otherwise all writes
+   * stay blocking.
+   * @param enable true to queue writes, false to wait for the queue to drain
+   * and write directly again
+   */
+  void setAsync(bool enable);
+  /*!
+   * @brief Selects what happens if a write does not fit into the queue.
+   * Commands are never dropped but always wait.
+   * @param policy LCD_QUEUE_BLOCK, LCD_QUEUE_DROP_OLDEST or LCD_QUEUE_SHORT
+   */
+  void setQueuePolicy(uint8_t policy);
+  /*!
+   * @brief Checks if the background transmission is still running
+   * @return true while data is sent
+   */
+  bool busy();
+  /*!
+   * @brief Fill level of the transmit queue
+   * @return Number of bytes waiting in the queue
+   */
+  uint8_t pending();
+  /*!
+   * @brief Waits until the transmit queue is empty
+   */
+  void waitIdle();
 
   /*!
    * @brief High-level command to set the backlight, only if the LCD backpack is
    * used
    * @param status Status to set the backlight
+   * @param lazy true to leave a change of the LEDs on port B to the next LCD
+   * transfer, which carries them for free, instead of writing them now
    */
-  void setBacklight(uint8_t status);
+  void setBacklight(uint8_t status, bool lazy = false);
 
   /*!
-   * @brief High-level command that creates custom characters in CGRAM
+   * @brief High-level command that creates custom characters in CGRAM, in a
+   * single I2C transaction.  The cursor stays where it was.
    * @param location Location in cgram to fill
    * @param charmap[] Character map to use
    */
   void createChar(uint8_t, uint8_t[]);
   /*!
-   * @brief High-level command that creates custom characters in CGRAM
+   * @brief High-level command that creates custom characters in CGRAM, in a
+   * single I2C transaction.  The cursor stays where it was.
    * @param location Location in cgram to fill
    * @param charmap[] Character map to use, data in PROGMEM
    */
   void createCharPgm(uint8_t location, const uint8_t *charmapP);
   /*!
-   * @brief High-level command that sets the location of the cursor
+   * @brief High-level command that sets the location of the cursor.  The
+   * library keeps track of the cursor, so this costs nothing if the cursor
+   * is already there.
    * @param col Column to put the cursor in
    * @param row Row to put the cursor in
    */
@@ -194,6 +458,47 @@ public:
    * @param len  Length of data
    */
   virtual size_t write(const uint8_t *, size_t);
+  /*!
+   * @brief Sends data in PROGMEM to the display, in the same bursts as
+   * write() of a buffer in RAM
+   * @param dataP Data to send, in PROGMEM
+   * @param len Length of data
+   * @return Number of bytes written
+   */
+  size_t writePgm(const uint8_t *dataP, size_t len);
+#if ARDUINO >= 100
+  using Print::print;
+  using Print::println;
+  /*!
+   * @brief Prints an F() string in bursts, see writePgm().  Print would
+   * send each character in a transaction of its own.
+   * @param str String in PROGMEM
+   * @return Number of bytes written
+   */
+  size_t print(const __FlashStringHelper *str);
+  /*!
+   * @brief Prints an F() string and a line break, see print()
+   * @param str String in PROGMEM
+   * @return Number of bytes written
+   */
+  size_t println(const __FlashStringHelper *str);
+#endif
+  /*!
+   * @brief Prints an integer or fixed-point number right-aligned in a field
+   * of fixed width, in one burst together with the padding.  The digits
+   * are computed without division.  A number which does not fit fills the
+   * field with '#'.
+   * @param value Number, in units of the last decimal: 1234 with two
+   * decimals prints 12.34
+   * @param width Width of the field, 0 for just as wide as needed
+   * @param decimals Number of digits after the decimal point
+   * @param pad ' ' to pad left of the sign, '0' to pad between sign and
+   * digits
+   * @return Number of characters written, fewer if LCD_QUEUE_SHORT cut the
+   * field off
+   */
+  size_t printField(int32_t value, uint8_t width, uint8_t decimals = 0,
+                    char pad = ' ');
   /*!
    * @brief Sends command to display
    * @param value Command to send
@@ -204,41 +509,188 @@ public:
    * @return Returns what buttons have been pressed
    */
   uint8_t readButtons();
+  /*!
+   * @brief Enables the button cache. readButtons() then returns the last
+   * sample while it is younger than the given time.  Samples are also taken
+   * while the display waits for the LCD anyway, i.e. during clear(), home()
+   * and deferred commands, so most calls do not need the bus.
+   * @param ms Lifetime of a sample in milliseconds, 0 to read the buttons on
+   * every call
+   */
+  void setButtonCache(uint16_t ms);
+  /*!
+   * @brief Age of the cached button state
+   * @return Milliseconds since the buttons were read
+   */
+  unsigned long buttonAge();
+  /*!
+   * @brief Writes the cached I/O expander configuration back to the chip,
+   * e.g. after it has been reset by someone else
+   */
+  void resync();
+
+  /*!
+   * @brief Finds the fastest I2C clock the wiring supports.  Steps the clock
+   * up by 100 kHz and checks each step by writing patterns to DDRAM and
+   * CGRAM and reading them back, together with the address counter.  Then
+   * sets the clock RGBLCD_CALIBRATE_MARGIN percent below the fastest step
+   * which passed.  Clears the display and overwrites custom character 0.
+   * @param max Highest clock to try in Hz, on AVR at most F_CPU / 16
+   * @param eeprom EEPROM address for the result, 5 bytes, or -1 to not store
+   * it.  Only on AVR.
+   * @return The clock now set in Hz, on AVR the one the TWI divider gives,
+   * 0 if the display fails even at 100 kHz
+   */
+  uint32_t calibrateClock(uint32_t max = 1000000, int eeprom = -1);
+  /*!
+   * @brief Sets the clock stored by calibrateClock(), call it after begin().
+   * Only on AVR.
+   * @param eeprom EEPROM address given to calibrateClock()
+   * @return The clock now set in Hz, 0 if none was stored
+   */
+  uint32_t restoreClock(int eeprom);
 
   int waitBusy();
 
+  /*!
+   * @brief Bus statistics of an operation since the last resetBusStats(),
+   * summed over all displays.  Traffic of nested calls counts for the outer
+   * operation, e.g. the commands of begin() for LCD_OP_BEGIN.  Requires
+   * RGBLCD_STATS, see RGBLCDShield_Fast_config.h, otherwise all counters
+   * are zero.
+   * @param op Operation, LCD_OP_SEND .. LCD_OP_OTHER
+   * @param stats Receives the counters
+   * @param clock I2C clock in Hz for the time estimate, 0 for the clock the
+   * bus runs at, or RGBLCD_I2C_CLOCK where it cannot be read
+   */
+  static void busStats(uint8_t op, RGBLCDBusStats &stats, uint32_t clock = 0);
+  /*!
+   * @brief Clears the bus statistics of all operations
+   */
+  static void resetBusStats();
+
+protected:
+  /*!
+   * @brief Pin layout of the backpack
+   * @return Masks and nibble table, shared by all instances
+   */
+  virtual const RGBLCDLayout &layout() const = 0;
+
 private:
+  bool start(uint8_t, uint8_t, uint8_t);
+  uint16_t reset(uint8_t);
+  void setup();
+  bool probe();
+  uint8_t readStatus();
+  void readLCD(uint8_t, uint8_t *, uint8_t);
+  bool verify();
+  bool verifyStatus(uint8_t);
+  void settle();
   void send(uint8_t, uint8_t);
+  uint8_t burst(uint8_t, uint8_t);
+  void endBurst();
+  void shadowWrite(uint8_t);
+  bool flushBegin();
+  void flushCells(uint8_t, uint8_t, uint8_t);
+  void flushEnd();
+  size_t writeBuffer(const uint8_t *, size_t, bool);
+  bool emit(uint8_t);
+  bool decode(uint8_t);
+  uint8_t glyph(uint16_t);
+  void track(uint8_t, uint8_t);
+  void wrap(uint8_t);
+  uint8_t rowStart(uint8_t) const;
   void write4bits(uint8_t);
+  uint8_t mapButtons(uint8_t);
+  uint8_t cgramBegin();
+  void cgramWrite(uint8_t, const uint8_t *, bool);
+  void cgramEnd(uint8_t);
+  void put(uint8_t, uint8_t, uint8_t);
+  void putAddr(uint8_t, uint8_t);
+  void putRows(uint8_t, uint8_t, uint8_t, uint8_t);
+  void putEnd();
+  bool buttonsStale();
+  uint8_t sampleButtons();
   void _digitalWrite(uint8_t, uint8_t);
   void _pinMode(uint8_t, uint8_t);
 
-  // the I/O expander pinout
-  const uint8_t _rs_pin = 15;     // LOW: command.  HIGH: character.
-  const uint8_t _rw_pin = 14;     // LOW: write to LCD.  HIGH: read from LCD.
-  const uint8_t _enable_pin = 13; // activated by a HIGH pulse.
-  const uint8_t _data_pins[4] = { 12, 11, 10, 9 };  // d4,d5,d6,d7
-  const uint8_t _button_pins[5] = { 0, 1, 2, 3, 4 };
-
-  // ... and the corresponding bit masks
-  const uint8_t _enable_mask = (1 << (_enable_pin % 8));
-  const uint8_t _rs_mask = (1 << (_rs_pin % 8));
-  const uint8_t _rw_mask = (1 << (_rw_pin % 8));
-  const uint8_t _data_mask[4] = {
-       uint8_t(1 << (_data_pins[0] % 8)),
-       uint8_t(1 << (_data_pins[1] % 8)),
-       uint8_t(1 << (_data_pins[2] % 8)),
-       uint8_t(1 << (_data_pins[3] % 8))
-     };
-
+  uint8_t _addr; // I2C address of the I/O expander
   uint8_t _displayfunction;
   uint8_t _displaycontrol;
   uint8_t _displaymode;
 
-  uint8_t _numlines, _currline;
+  uint8_t _numlines, _currline, _numcols;
   uint8_t _rw_state, _rs_state;
-  uint8_t _backlight;
+  uint8_t _gpiob; // backlight bits on port B, all LCD lines low
+  uint8_t _burst; // bytes in the open I2C transaction, 0 if none
+  bool _cgram_burst; // a CGRAM upload went into the caller's burst
+  bool _deferred;           // clear() and home() do not wait
+  bool _pending;            // a deferred command is still executing
+  unsigned long _ready_at;  // micros() when it is done
+  uint8_t _buttons;         // cached button state
+  uint16_t _buttons_ttl;    // lifetime of the cache in ms, 0 if disabled
+  unsigned long _buttons_at;  // millis() of the sample
+  uint8_t _ac;              // address counter, 0xfe in CGRAM, 0xff unknown
+  bool _wrap;               // see lineWrap()
+  uint8_t _draw_page;       // page setCursor() addresses
+  uint8_t _show_page;       // page the display shift shows
+  uint8_t _charset;         // see setCharset()
+  uint8_t _utf8_need;       // continuation bytes missing, see decode()
+  uint16_t _utf8_cp;        // code point decoded so far
+  RGBLCDGlyphs *_glyphs;    // fallback for code points without ROM glyph
+  const uint16_t *_glyph_codes; // their code points, in PROGMEM
+#ifdef RGBLCD_TWI_ASYNC
+  bool _async;
+  uint8_t _policy;
+#endif
+
+  // shadow framebuffer: requested content followed by displayed content
+  uint8_t *_shadow;
+  uint8_t _shadow_col, _shadow_row;
+  bool _shadow_valid; // displayed half matches the LCD
+  RGBLCDFlushStats _flush_stats;
+
   MCP23017 _i2c;
 };
 
+/*!
+ * @brief RGB LCD shield with a pin layout fixed at compile time
+ *
+ * The pin masks and the nibble table live once per layout instead of in
+ * every instance, and encoding a nibble is a single table lookup.
+ * @tparam Layout Struct with the pin numbers, see AdafruitShieldLayout
+ */
+template <class Layout = AdafruitShieldLayout>
+class RGBLCDShield_FastT : public RGBLCDShield_FastBase {
+  static_assert(Layout::rs >= 8 && Layout::rw >= 8 && Layout::enable >= 8 &&
+                    Layout::d4 >= 8 && Layout::d5 >= 8 && Layout::d6 >= 8 &&
+                    Layout::d7 >= 8 && Layout::rs < 16 && Layout::rw < 16 &&
+                    Layout::enable < 16 && Layout::d4 < 16 &&
+                    Layout::d5 < 16 && Layout::d6 < 16 && Layout::d7 < 16,
+                "the LCD lines must be on port B");
+  static_assert(Layout::select < 8 && Layout::right < 8 && Layout::down < 8 &&
+                    Layout::up < 8 && Layout::left < 8,
+                "the buttons must be on port A");
+
+public:
+  /*!
+   * @brief Constructor
+   * @param addr Address of the shield as set by the A0..A2 jumpers, 0..7
+   */
+  explicit RGBLCDShield_FastT(uint8_t addr = 0)
+      : RGBLCDShield_FastBase(addr) {}
+
+  //! Masks and nibble table of Layout
+  static constexpr RGBLCDLayout pinout = RGBLCDLayout::make<Layout>();
+
+protected:
+  virtual const RGBLCDLayout &layout() const { return pinout; }
+};
+
+template <class Layout>
+constexpr RGBLCDLayout RGBLCDShield_FastT<Layout>::pinout;
+
+//! The Adafruit RGB LCD shield
+typedef RGBLCDShield_FastT<AdafruitShieldLayout> RGBLCDShield_Fast;
+
 #endif
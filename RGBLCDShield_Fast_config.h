@@ -0,0 +1,94 @@
+/*!
+ * @file RGBLCDShield_Fast_config.h
+ *
+ * Compile time options of the library.  Either edit this file or pass the
+ * defines as build flags.
+ */
+
+#ifndef RGBLCDShield_Fast_config_h
+#define RGBLCDShield_Fast_config_h
+
+// Drive the AVR TWI hardware directly instead of using the Wire library.
+// Bursts then go straight from the LCD encoder into TWDR without the 32 byte
+// buffer of Wire, so a whole screen fits into a single transaction.  The
+// sketch may still use Wire for other devices.
+//#define RGBLCD_TWI
+
+// Like RGBLCD_TWI, plus the interrupt driven transmit queue, see
+// RGBLCDShield_FastBase::setAsync().  The library then owns the TWI
+// interrupt, so the sketch must not include <Wire.h>.  Use TWIM.setClock()
+// instead of Wire.setClock().
+//#define RGBLCD_TWI_ASYNC
+
+#if defined(RGBLCD_TWI_ASYNC) && !defined(RGBLCD_TWI)
+#define RGBLCD_TWI
+#endif
+
+// Talk to the shield through Linux i2c-dev, e.g. on a Raspberry Pi, see
+// utility/LinuxI2C.h and extras/linux.  Like RGBLCD_TWI, bursts are not
+// split into chunks of 32 bytes.
+//#define RGBLCD_LINUX_I2C
+
+#ifndef RGBLCD_I2C_DEVICE
+#define RGBLCD_I2C_DEVICE "/dev/i2c-1" //!< Bus opened by RGBLCD_LINUX_I2C
+#endif
+
+// Count the I2C traffic of each operation, see
+// RGBLCDShield_FastBase::busStats().  Costs about 200 bytes of RAM and a few
+// instructions per bus access; without it the counters are compiled out.
+//#define RGBLCD_STATS
+
+// I2C clock assumed by the bus time estimate of the statistics on
+// architectures where the library cannot read it from the hardware.
+#ifndef RGBLCD_I2C_CLOCK
+#define RGBLCD_I2C_CLOCK 100000 //!< I2C clock in Hz if it is unknown
+#endif
+
+// Distance of the clock chosen by RGBLCDShield_FastBase::calibrateClock()
+// from the fastest clock which passed, in percent.
+#ifndef RGBLCD_CALIBRATE_MARGIN
+#define RGBLCD_CALIBRATE_MARGIN 25 //!< Safety margin of the calibration
+#endif
+
+// Time reserved for clear() and home() in deferred mode, see
+// RGBLCDShield_FastBase::setDeferred().  The datasheet specifies 1.52 ms at
+// the nominal oscillator frequency, the margin covers slower controllers.
+#ifndef RGBLCD_CLEAR_US
+#define RGBLCD_CLEAR_US 2000 //!< Execution time of clear/home in microseconds
+#endif
+
+// Longest time a colour change of RGBLCDBacklight waits for an LCD transfer
+// to carry the LEDs on port B before it writes them itself, and the period
+// of the duty cycle of its fades.
+#ifndef RGBLCD_BACKLIGHT_LAG_MS
+#define RGBLCD_BACKLIGHT_LAG_MS 20 //!< Delay of lazy backlight changes in ms
+#endif
+#ifndef RGBLCD_FADE_PERIOD_MS
+#define RGBLCD_FADE_PERIOD_MS 40 //!< Period of the fade duty cycle in ms
+#endif
+
+// Timing of RGBLCDButtons: a release is only accepted once the button was
+// stable for RGBLCD_DEBOUNCE_MS.  Held buttons report a long press after
+// RGBLCD_LONG_PRESS_MS and repeat every RGBLCD_REPEAT_MS, starting after
+// RGBLCD_REPEAT_DELAY_MS.  A repeat time of 0 disables repeats.
+#ifndef RGBLCD_DEBOUNCE_MS
+#define RGBLCD_DEBOUNCE_MS 20 //!< Minimum stable time of a release in ms
+#endif
+#ifndef RGBLCD_LONG_PRESS_MS
+#define RGBLCD_LONG_PRESS_MS 1000 //!< Hold time of a long press in ms
+#endif
+#ifndef RGBLCD_REPEAT_DELAY_MS
+#define RGBLCD_REPEAT_DELAY_MS 500 //!< Hold time before the first repeat
+#endif
+#ifndef RGBLCD_REPEAT_MS
+#define RGBLCD_REPEAT_MS 200 //!< Interval of repeats in ms, 0 for none
+#endif
+#ifndef RGBLCD_EVENT_QUEUE_SIZE
+#define RGBLCD_EVENT_QUEUE_SIZE 8 //!< Number of queued button events
+#endif
+
+#ifndef RGBLCD_QUEUE_SIZE
+#define RGBLCD_QUEUE_SIZE 64 //!< Size of the transmit queue in bytes
+#endif
+
+#endif
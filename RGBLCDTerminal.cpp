@@ -0,0 +1,293 @@
+/*!
+ * @file RGBLCDTerminal.cpp
+ *
+ * VT100 subset on the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDTerminal.h"
+
+#include <string.h>
+
+// states of the escape sequence parser
+#define TERM_TEXT 0
+#define TERM_ESC 1 // after ESC
+#define TERM_CSI 2 // after ESC [
+
+RGBLCDTerminal::RGBLCDTerminal(RGBLCDShield_FastBase &lcd, uint8_t *buffer)
+    : _lcd(lcd), _buffer(buffer), _cols(0), _rows(0), _col(0), _row(0),
+      _saved_col(0), _saved_row(0), _state(TERM_TEXT), _nparams(0),
+      _private(false), _newline(true), _dirty(false), _paused(false) {}
+
+void RGBLCDTerminal::begin() {
+  _cols = _lcd._numcols;
+  _rows = _lcd._numlines;
+  _lcd.shadow(_buffer);
+  _col = _row = _saved_col = _saved_row = 0;
+  _state = TERM_TEXT;
+  _newline = true;
+  _dirty = true;
+  flush();
+}
+
+void RGBLCDTerminal::update(Stream &io, bool flow) {
+  watch(io, flow);
+  uint8_t n = 0;
+  while (n < 255 && io.available() > 0) {
+    process(io.read());
+    n++;
+  }
+  if (_dirty) {
+    // The sender may be much faster than the bus, keep an eye on the input
+    // while the cells go out.
+    _lcd.setCursor((_col < _cols) ? _col : _cols - 1, _row);
+    if (_lcd.flushBegin()) {
+      for (uint8_t i = 0; i < 4; i++)
+        for (uint8_t col = 0; col < _cols; col += RGBLCD_TERM_POLL) {
+          uint8_t to = col + RGBLCD_TERM_POLL;
+          watch(io, flow);
+          _lcd.flushCells(i, col, (to < _cols) ? to : _cols);
+        }
+      _lcd.flushEnd();
+    }
+    _dirty = false;
+  }
+  if (_paused && io.available() < RGBLCD_TERM_XON_AT) {
+    io.write(RGBLCD_XON);
+    _paused = false;
+  }
+}
+
+// Stops the sender before the receive buffer overflows.
+void RGBLCDTerminal::watch(Stream &io, bool flow) {
+  if (flow && !_paused && io.available() >= RGBLCD_TERM_XOFF_AT) {
+    io.write(RGBLCD_XOFF);
+    _paused = true;
+  }
+}
+
+size_t RGBLCDTerminal::write(uint8_t c) {
+  process(c);
+  flush();
+  return 1;
+}
+
+size_t RGBLCDTerminal::write(const uint8_t *buffer, size_t size) {
+  for (size_t i = 0; i < size; i++)
+    process(buffer[i]);
+  flush();
+  return size;
+}
+
+void RGBLCDTerminal::flush() {
+  if (!_dirty)
+    return;
+  // the visible cursor stays on the last column at the end of a row
+  _lcd.setCursor((_col < _cols) ? _col : _cols - 1, _row);
+  _lcd.flush();
+  _dirty = false;
+}
+
+void RGBLCDTerminal::process(uint8_t c) {
+  _dirty = true;
+  switch (_state) {
+  case TERM_ESC:
+    _state = TERM_TEXT;
+    if (c == '[') {
+      _state = TERM_CSI;
+      _nparams = 0;
+      _params[0] = 0;
+      _private = false;
+    } else if (c == '7') {
+      _saved_col = _col;
+      _saved_row = _row;
+    } else if (c == '8') {
+      _col = _saved_col;
+      _row = _saved_row;
+    } else if (c == 'c') {
+      sgr(0);
+      erase(0, _cols * _rows);
+      _col = _row = 0;
+      _newline = true;
+    }
+    return;
+  case TERM_CSI:
+    sequence(c);
+    return;
+  }
+  if (c < 0x20 || c == 0x7f)
+    control(c);
+  else
+    put(c);
+}
+
+void RGBLCDTerminal::control(uint8_t c) {
+  switch (c) {
+  case 0x1b: // ESC
+    _state = TERM_ESC;
+    break;
+  case '\r':
+    _col = 0;
+    break;
+  case '\n':
+  case 0x0b: // VT
+    if (_newline)
+      _col = 0;
+    newline();
+    break;
+  case '\b':
+    if (_col > 0)
+      _col--;
+    break;
+  case '\t':
+    _col = (_col | 7) + 1;
+    if (_col >= _cols)
+      _col = _cols - 1;
+    break;
+  case 0x0c: // FF
+    erase(0, _cols * _rows);
+    _col = _row = 0;
+    break;
+  default:
+    break; // BEL, XON, XOFF, DEL and others
+  }
+}
+
+// Collects the parameters of ESC [ and acts on the final character.
+void RGBLCDTerminal::sequence(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    uint8_t &p = _params[_nparams];
+    p = (p > 25 || (p == 25 && c > '5')) ? 255 : p * 10 + (c - '0');
+    return;
+  }
+  if (c == ';') {
+    if (_nparams < sizeof(_params) - 1)
+      _params[++_nparams] = 0;
+    return;
+  }
+  if (c == '?') {
+    _private = true;
+    return;
+  }
+  _nparams++;
+  _state = TERM_TEXT;
+
+  uint8_t n = param(0, 1);
+  uint8_t pos = _row * _cols + ((_col < _cols) ? _col : _cols - 1);
+  switch (c) {
+  case 'H':
+  case 'f':
+    _row = param(0, 1) - 1;
+    _col = param(1, 1) - 1;
+    if (_row >= _rows)
+      _row = _rows - 1;
+    if (_col >= _cols)
+      _col = _cols - 1;
+    break;
+  case 'A':
+    _row = (n < _row) ? _row - n : 0;
+    break;
+  case 'B':
+    _row = (n < _rows - _row) ? _row + n : _rows - 1;
+    break;
+  case 'C':
+    _col = (n < _cols - _col) ? _col + n : _cols - 1;
+    break;
+  case 'D':
+    if (_col >= _cols)
+      _col = _cols - 1;
+    _col = (n < _col) ? _col - n : 0;
+    break;
+  case 'J':
+    switch (param(0, 0)) {
+    case 0:
+      erase(pos, _cols * _rows);
+      break;
+    case 1:
+      erase(0, pos + 1);
+      break;
+    default:
+      erase(0, _cols * _rows);
+      break;
+    }
+    break;
+  case 'K':
+    switch (param(0, 0)) {
+    case 0:
+      erase(pos, (_row + 1) * _cols);
+      break;
+    case 1:
+      erase(_row * _cols, pos + 1);
+      break;
+    default:
+      erase(_row * _cols, (_row + 1) * _cols);
+      break;
+    }
+    break;
+  case 'm':
+    for (uint8_t i = 0; i < _nparams; i++)
+      sgr(_params[i]);
+    break;
+  case 's':
+    _saved_col = _col;
+    _saved_row = _row;
+    break;
+  case 'u':
+    _col = _saved_col;
+    _row = _saved_row;
+    break;
+  case 'h':
+  case 'l':
+    if (_private && n == 25) {
+      if (c == 'h')
+        _lcd.cursor();
+      else
+        _lcd.noCursor();
+    } else if (!_private && n == 20) {
+      _newline = (c == 'h');
+    }
+    break;
+  default:
+    break; // not supported
+  }
+}
+
+// Selects the backlight from a colour of SGR.
+void RGBLCDTerminal::sgr(uint8_t n) {
+  if (n == 0 || n == 39 || n == 49)
+    _lcd.setBacklight(0x7);
+  else if ((n >= 30 && n <= 37) || (n >= 40 && n <= 47))
+    _lcd.setBacklight(n % 10); // red 1, green 2, blue 4
+}
+
+void RGBLCDTerminal::put(uint8_t c) {
+  if (_col >= _cols) {
+    // the previous character filled the row
+    _col = 0;
+    newline();
+  }
+  _buffer[_row * _cols + _col] = c;
+  _col++;
+}
+
+// Moves the cursor down one row, at the bottom the text scrolls up.
+void RGBLCDTerminal::newline() {
+  if (_row + 1 < _rows) {
+    _row++;
+    return;
+  }
+  memmove(_buffer, _buffer + _cols, _cols * (_rows - 1));
+  erase(_cols * (_rows - 1), _cols * _rows);
+}
+
+// Blanks the cells from one index of the screen up to another.
+void RGBLCDTerminal::erase(uint8_t from, uint8_t to) {
+  if (to > from)
+    memset(_buffer + from, ' ', to - from);
+}
+
+// Parameter of a control sequence, with a default for 0 or missing.
+uint8_t RGBLCDTerminal::param(uint8_t i, uint8_t def) const {
+  return (i < _nparams && _params[i] != 0) ? _params[i] : def;
+}
@@ -0,0 +1,115 @@
+/*!
+ * @file RGBLCDTerminal.h
+ */
+
+#ifndef RGBLCDTerminal_h
+#define RGBLCDTerminal_h
+
+#include "Stream.h"
+#include <RGBLCDShield_Fast.h>
+
+//! Bytes waiting in the receive buffer from which update() stops the sender
+//! with XOFF, half of the 64 bytes of the AVR serial ports
+#ifndef RGBLCD_TERM_XOFF_AT
+#define RGBLCD_TERM_XOFF_AT 32
+#endif
+//! Bytes waiting below which update() resumes the sender with XON
+#ifndef RGBLCD_TERM_XON_AT
+#define RGBLCD_TERM_XON_AT 8
+#endif
+//! Cells update() sends between two looks at the receive buffer
+#ifndef RGBLCD_TERM_POLL
+#define RGBLCD_TERM_POLL 4
+#endif
+
+#define RGBLCD_XON 0x11  //!< Resume transmission (DC1)
+#define RGBLCD_XOFF 0x13 //!< Pause transmission (DC3)
+
+/*!
+ * @brief Terminal which shows a stream of text with a subset of VT100
+ * control sequences
+ *
+ * Characters go to the shadow framebuffer of the display, flush() sends
+ * the cells which changed in one burst.  Input which arrives while the
+ * display is updated is thus coalesced, and a full screen never takes more
+ * than one pass over the bus.
+ *
+ * Understood are CR, LF (with CR, see ESC[20l), BS, TAB, FF (clear) and
+ * the sequences ESC[<row>;<col>H and f, ESC[<n>A, B, C, D, ESC[<n>J and
+ * K, ESC[s and u, ESC 7 and 8, ESC c, ESC[?25h and l (cursor) and
+ * ESC[20h and l (new line mode).  The colours of SGR, ESC[<n>m, set the
+ * backlight: 30..37 and 40..47 in the ANSI order, whose bits match the
+ * backlight bits, 0, 39 and 49 back to white.  Text at the end of the
+ * last row scrolls the screen up.
+ *
+ * The terminal owns the display: it enables the shadow framebuffer.
+ */
+class RGBLCDTerminal : public Print {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display to show the text on
+   * @param buffer Shadow framebuffer, LCD_SHADOW_SIZE(cols, rows) bytes
+   */
+  RGBLCDTerminal(RGBLCDShield_FastBase &lcd, uint8_t *buffer);
+
+  /*!
+   * @brief Enables the shadow framebuffer and clears the screen, call it
+   * after begin() of the display
+   */
+  void begin();
+  /*!
+   * @brief Reads all input available, at most 255 bytes, and shows it.
+   * Before and while the display is updated, XOFF pauses the sender as soon
+   * as RGBLCD_TERM_XOFF_AT bytes are waiting.  XON resumes it once fewer
+   * than RGBLCD_TERM_XON_AT are left at the end of an update().
+   * @param io Serial port or other stream, which also receives XON/XOFF
+   * @param flow false to not send XON/XOFF
+   */
+  void update(Stream &io, bool flow = true);
+
+  /*!
+   * @brief Shows one character or control code, and updates the display
+   * @param c Character
+   * @return 1
+   */
+  virtual size_t write(uint8_t c);
+  /*!
+   * @brief Shows a text with control codes, and updates the display once
+   * @param buffer Text
+   * @param size Length of the text
+   * @return size
+   */
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  using Print::write;
+  /*!
+   * @brief Updates the display with the text processed so far
+   */
+  virtual void flush();
+
+private:
+  void watch(Stream &io, bool flow);
+  void process(uint8_t c);
+  void control(uint8_t c);
+  void sequence(uint8_t c);
+  void sgr(uint8_t n);
+  void put(uint8_t c);
+  void newline();
+  void erase(uint8_t from, uint8_t to);
+  uint8_t param(uint8_t i, uint8_t def) const;
+
+  RGBLCDShield_FastBase &_lcd;
+  uint8_t *_buffer;
+  uint8_t _cols, _rows;
+  uint8_t _col, _row;          // cursor, _col == _cols at the end of a row
+  uint8_t _saved_col, _saved_row;
+  uint8_t _state;              // escape sequence parser
+  uint8_t _params[4];          // numbers of a control sequence
+  uint8_t _nparams;
+  bool _private;               // control sequence starts with '?'
+  bool _newline;               // LF also returns the carriage
+  bool _dirty;                 // not flushed yet
+  bool _paused;                // XOFF sent
+};
+
+#endif
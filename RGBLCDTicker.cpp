@@ -0,0 +1,94 @@
+/*!
+ * @file RGBLCDTicker.cpp
+ *
+ * Marquee on the display shift of the RGB LCD shield.
+ *
+ * Written by Bastian Maerkisch.  BSD license.
+ */
+
+#include "RGBLCDTicker.h"
+
+#include <string.h>
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#define DDRAM_COLS 40 // columns of a DDRAM line in 2-line mode
+
+RGBLCDTicker::RGBLCDTicker(RGBLCDShield_FastBase &lcd, uint8_t row)
+    : _lcd(lcd), _row(row), _base(0), _text(""), _progmem(false), _len(0),
+      _period(DDRAM_COLS), _pos(0), _shift(0), _ahead(0) {}
+
+void RGBLCDTicker::begin(const char *text) {
+  load(text, false);
+}
+
+void RGBLCDTicker::beginPgm(const char *textP) {
+  load(textP, true);
+}
+
+void RGBLCDTicker::load(const char *text, bool progmem) {
+  _text = text;
+  _progmem = progmem;
+  _len = progmem ? strlen_P(text) : strlen(text);
+  // The text scrolls out before it comes back.  If it repeats after
+  // exactly 40 columns, the DDRAM never needs a refill.
+  _period = _len + _lcd._numcols;
+  if (_period < DDRAM_COLS)
+    _period = DDRAM_COLS;
+  _pos = 0;
+  _shift = 0;
+  _ahead = DDRAM_COLS - _lcd._numcols;
+  // rows 2 and 3 start in the middle of the DDRAM lines of rows 0 and 1
+  _base = (_lcd._numlines > 2 && _row >= 2) ? DDRAM_COLS / 2 : 0;
+
+  _lcd.home(); // display shift 0
+  for (uint8_t col = 0; col < DDRAM_COLS; col++)
+    put(col, at(col));
+  _lcd.putEnd();
+}
+
+void RGBLCDTicker::step() {
+  _lcd.burst(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT, LOW);
+  if (++_pos == _period)
+    _pos = 0;
+  if (++_shift == DDRAM_COLS)
+    _shift = 0;
+
+  if (_ahead > 0) {
+    _ahead--; // still loaded by begin()
+  } else if (_period > DDRAM_COLS) {
+    // The column coming into view at the right edge still holds the
+    // character which left at the left edge 40 steps ago.
+    uint16_t i = _pos + _lcd._numcols - 1;
+    if (i >= _period)
+      i -= _period;
+    uint16_t old = (i >= DDRAM_COLS) ? i - DDRAM_COLS
+                                     : i + _period - DDRAM_COLS;
+    uint8_t c = at(i);
+    if (c != at(old)) {
+      put(_shift + _lcd._numcols - 1, c);
+    }
+  }
+  _lcd.putEnd();
+}
+
+// Writes a character to a column of the DDRAM line of the row, counted from
+// the left edge of the row at display shift 0, modulo 40.
+void RGBLCDTicker::put(uint8_t col, uint8_t c) {
+  col += _base;
+  while (col >= DDRAM_COLS)
+    col -= DDRAM_COLS;
+  // the whole DDRAM line, whatever page is drawn to
+  _lcd.putAddr(((_base ? _row - 2 : _row) ? 0x40 : 0x00) + col, c);
+}
+
+// Character at an index of the text followed by blanks.
+uint8_t RGBLCDTicker::at(uint16_t i) const {
+  if (i >= _len)
+    return ' ';
+  return _progmem ? pgm_read_byte(_text + i) : (uint8_t)_text[i];
+}
@@ -0,0 +1,78 @@
+/*!
+ * @file RGBLCDTicker.h
+ */
+
+#ifndef RGBLCDTicker_h
+#define RGBLCDTicker_h
+
+#include <RGBLCDShield_Fast.h>
+
+/*!
+ * @brief Marquee which scrolls a text through a row with the display shift
+ * of the LCD
+ *
+ * Each row has 40 columns of DDRAM, of which only the first ones are
+ * visible.  The ticker loads the text into all 40 columns once, and each
+ * step is a single scrollDisplayLeft() command.  Texts which do not fit
+ * into 40 columns together with a row of blanks are refilled one column at
+ * a time, just before the column comes into view.
+ *
+ * The display shift moves all rows: the other rows scroll along, and there
+ * can be only one ticker per display.  Screen column c of rows 0 and 1 is
+ * DDRAM column (c + shift()) % 40.  On displays with four rows, rows 2 and
+ * 3 show the second half of the DDRAM lines of rows 0 and 1, from column 20
+ * on.  A ticker there is loaded into that line with the same offset, so its
+ * text scrolls on from the left edge of row 2 into the right edge of row 0,
+ * and likewise for rows 3 and 1.  The ticker does not work with the shadow
+ * framebuffer or with pages, which use the display shift as well, and it
+ * moves the cursor.
+ */
+class RGBLCDTicker {
+public:
+  /*!
+   * @brief Constructor
+   * @param lcd Display to draw on
+   * @param row Row of the text
+   */
+  RGBLCDTicker(RGBLCDShield_FastBase &lcd, uint8_t row);
+
+  /*!
+   * @brief Shows a text, starting at the left edge.  Resets the display
+   * shift with home().  The text scrolls out completely before it starts
+   * again.
+   * @param text Text, must stay valid while the ticker runs
+   */
+  void begin(const char *text);
+  /*!
+   * @brief Shows a text in PROGMEM, see begin()
+   * @param textP Text in PROGMEM
+   */
+  void beginPgm(const char *textP);
+  /*!
+   * @brief Scrolls the text left by one column, in a single I2C transaction
+   */
+  void step();
+  /*!
+   * @brief Current display shift
+   * @return DDRAM column shown at the left edge, 0..39
+   */
+  uint8_t shift() const { return _shift; }
+
+private:
+  void load(const char *text, bool progmem);
+  void put(uint8_t col, uint8_t c);
+  uint8_t at(uint16_t i) const;
+
+  RGBLCDShield_FastBase &_lcd;
+  uint8_t _row;
+  uint8_t _base; // DDRAM column of the left edge without display shift
+  const char *_text;
+  bool _progmem;
+  uint16_t _len;    // length of the text
+  uint16_t _period; // text and blanks, at least 40 columns
+  uint16_t _pos;    // index of the character at the left edge
+  uint8_t _shift;   // display shift
+  uint8_t _ahead;   // preloaded columns right of the visible ones
+};
+
+#endif
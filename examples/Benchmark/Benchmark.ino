@@ -24,13 +24,19 @@
 //#define I2CLOCK 615384
 
 #if defined(USE_RGBLCDSHIELD) || defined(USE_RGBLCDSHIELDFAST)
-# include <Wire.h>
 # ifdef USE_RGBLCDSHIELDFAST
 #  include <RGBLCDShield_Fast.h>
 # else
 #  include <Adafruit_RGBLCDShield.h>
 #  include <utility/Adafruit_MCP23017.h>
 # endif
+// With RGBLCD_TWI_ASYNC the library owns the TWI hardware, see
+// RGBLCDShield_Fast_config.h.
+# ifdef RGBLCD_TWI_ASYNC
+#  define I2C TWIM
+# else
+#  include <Wire.h>
+# endif
 #endif
 
 #ifdef USE_LIQUIDCRYSTALIO
@@ -65,6 +71,10 @@ LiquidCrystal lcd(rs, rw, en, d4, d5, d6, d7, ioFrom23017(0x20));
 LiquidTWI2 lcd(MCP23017_ADDRESS);
 #endif
 
+#ifndef I2C
+# define I2C Wire
+#endif
+
 // These #defines make it easy to set the backlight color
 #define RED 0x1
 #define YELLOW 0x3
@@ -94,7 +104,7 @@ void setup(void) {
 #endif
 
 #if defined(USE_RGBLCDSHIELD) || defined(USE_RGBLCDSHIELDFAST) || defined(USE_LIQUIDTWI)
-  Wire.begin();
+  I2C.begin();
   lcd.begin(nColumns,nRows);
   lcd.setBacklight(WHITE);
 #endif
@@ -104,12 +114,14 @@ void setup(void) {
   // reset to defaults.
   // Speed: 7281 ms -> 2733 ms
   // Wire.setClock(400000);
-  Wire.setClock(I2CLOCK);
+  I2C.setClock(I2CLOCK);
   //TWBR = 0x05;
 
+  // SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS)
+  unsigned long scl = F_CPU / (16 + 2UL * TWBR * (1 << 2 * (TWSR & 0x3)));
   Serial.print(F("TWBR: "));
   Serial.println(TWBR, 16);
-  Serial.println(F_CPU / (16 + (2 * TWBR)));
+  Serial.println(scl);
 
   lcd.clear();
   lcd.setCursor(0,0);
@@ -121,6 +133,9 @@ void setup(void) {
   }
   text[length] = 0;
   blanks[length] = 0;
+#if defined(USE_RGBLCDSHIELDFAST) && defined(RGBLCD_STATS)
+  RGBLCDShield_Fast::resetBusStats();
+#endif
   unsigned long startTime=millis();
   byte repetitions = 20;
   while (repetitions--) {
@@ -130,6 +145,10 @@ void setup(void) {
     lcd.print(blanks);
   }
   unsigned long endTime = millis();
+#if defined(USE_RGBLCDSHIELDFAST) && defined(RGBLCD_STATS)
+  RGBLCDBusStats stats; // of the prints above only
+  RGBLCDShield_Fast::busStats(LCD_OP_WRITE, stats);
+#endif
   lcd.clear();
   lcd.setCursor(0,0);
   lcd.print(F("Benchmark "));
@@ -148,6 +167,35 @@ void setup(void) {
   lcd.write('x');
   //Serial.println(endTime - startTime);
   //Serial.println(x);
+
+#ifdef USE_RGBLCDSHIELDFAST
+  // Through Wire, a print() is cut into transactions of at most 7 characters
+  // due to its 32 byte buffer.  Every extra transaction costs START, address,
+  // register pointer and STOP, i.e. 20 bit times.  The direct TWI transport
+  // sends each print() as one transaction.
+  // 20 repetitions of two prints
+  unsigned long viaWire = 2UL * 20 * ((length + 6) / 7);
+# if defined(RGBLCD_TWI) && defined(RGBLCD_STATS)
+  // measured
+  unsigned long used = stats.transactions;
+  Serial.print(F("Transport: direct TWI, "));
+  Serial.print(used);
+  Serial.print(F(" transactions instead of "));
+  Serial.print(viaWire);
+  Serial.print(F(" through Wire, bus time saved: "));
+# else
+  // Define RGBLCD_STATS to count the transactions instead.
+  unsigned long used = 2UL * 20;
+#  ifdef RGBLCD_TWI
+  Serial.print(F("Transport: direct TWI, estimated bus time saved: "));
+#  else
+  Serial.print(F("Transport: Wire, estimated bus time to save with RGBLCD_TWI: "));
+#  endif
+# endif
+  unsigned long saved = (viaWire > used) ? (viaWire - used) * 20 * 1000 / scl : 0;
+  Serial.print(saved);
+  Serial.println(F(" ms"));
+#endif
 }
 
 void loop() {
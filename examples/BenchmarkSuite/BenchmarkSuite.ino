@@ -0,0 +1,52 @@
+/*********************
+
+Benchmark suite for the RGB LCD shield library
+
+Times single characters, numbers, fixed-width fields, flash strings, cursor
+jumps, clear(), home(), createChar(), readButtons() and setBacklight() at
+100 kHz, 400 kHz and a TWBR of your choice, and prints one CSV line per
+scenario and clock to Serial, see Scenarios.h.  The host build in
+extras/host runs the same scenarios against the emulator: "make bench".
+
+For the I2C bytes per operation, define RGBLCD_STATS in
+RGBLCDShield_Fast_config.h.
+
+**********************/
+
+#include <RGBLCDShield_Fast.h>
+// With RGBLCD_TWI_ASYNC the library owns the TWI hardware, see
+// RGBLCDShield_Fast_config.h.
+#ifdef RGBLCD_TWI_ASYNC
+#define I2C TWIM
+#else
+#include <Wire.h>
+#define I2C Wire
+#endif
+
+#include "Scenarios.h"
+
+// Fastest setting of the third run: TWBR = 5 is 615 kHz at 16 MHz.
+#define BENCH_TWBR 5
+
+RGBLCDShield_Fast lcd = RGBLCDShield_Fast();
+
+void setup() {
+  Serial.begin(57600);
+  lcd.begin(16, 2);
+
+  benchHeader(Serial);
+  I2C.setClock(100000);
+  benchRun(lcd, Serial, 100000);
+  I2C.setClock(400000);
+  benchRun(lcd, Serial, 400000);
+#ifdef TWBR
+  TWBR = BENCH_TWBR; // the prescaler is 1 after setClock()
+  benchRun(lcd, Serial, F_CPU / (16 + 2UL * BENCH_TWBR));
+#endif
+
+  lcd.clear();
+  lcd.print(F("Benchmark done"));
+}
+
+void loop() {
+}
@@ -0,0 +1,160 @@
+/*********************
+
+Scenarios of the benchmark suite, shared by BenchmarkSuite.ino and the host
+build in extras/host ("make bench"), so the numbers of both can be compared.
+
+Each scenario repeats one kind of operation.  The output is one CSV line per
+scenario:
+
+  scenario,clock_hz,ops,us_per_op,bytes_per_op
+
+The bytes include the address byte of every transaction and need the bus
+statistics of the library (RGBLCD_STATS in RGBLCDShield_Fast_config.h),
+otherwise the column shows "-".
+
+**********************/
+
+#ifndef BENCHMARK_SCENARIOS_H
+#define BENCHMARK_SCENARIOS_H
+
+#include <RGBLCDShield_Fast.h>
+
+enum {
+  BENCH_WRITE,      // single character, the cursor advances
+  BENCH_UPDATE,     // single character at a fixed position
+  BENCH_PRINT_INT,  // counter with print(int)
+  BENCH_FIELD,      // fixed-point field with printField()
+  BENCH_PRINT_F,    // text from flash with print(F())
+  BENCH_CURSOR,     // cursor jump
+  BENCH_CLEAR,      // clear()
+  BENCH_HOME,       // home()
+  BENCH_CREATECHAR, // createChar()
+  BENCH_BUTTONS,    // readButtons()
+  BENCH_BACKLIGHT,  // setBacklight() with a new colour
+  BENCH_SCENARIOS
+};
+
+static const __FlashStringHelper *benchName(uint8_t scenario) {
+  switch (scenario) {
+  case BENCH_WRITE:
+    return F("write");
+  case BENCH_UPDATE:
+    return F("update");
+  case BENCH_PRINT_INT:
+    return F("print_int");
+  case BENCH_FIELD:
+    return F("printField");
+  case BENCH_PRINT_F:
+    return F("print_F");
+  case BENCH_CURSOR:
+    return F("cursor");
+  case BENCH_CLEAR:
+    return F("clear");
+  case BENCH_HOME:
+    return F("home");
+  case BENCH_CREATECHAR:
+    return F("createChar");
+  case BENCH_BUTTONS:
+    return F("readButtons");
+  default:
+    return F("setBacklight");
+  }
+}
+
+// clear() and home() wait for the LCD, fewer repetitions do.
+static uint16_t benchOps(uint8_t scenario) {
+  return (scenario == BENCH_CLEAR || scenario == BENCH_HOME) ? 20 : 100;
+}
+
+static void benchOp(RGBLCDShield_Fast &lcd, uint8_t scenario, uint16_t i) {
+  uint8_t glyph[8] = {0x00, 0x0a, 0x1f, 0x1f, 0x0e, 0x04, 0x00, 0x00};
+
+  switch (scenario) {
+  case BENCH_WRITE:
+    lcd.write('A' + i % 26);
+    break;
+  case BENCH_UPDATE:
+    lcd.setCursor(15, 0);
+    lcd.write('0' + i % 10);
+    break;
+  case BENCH_PRINT_INT:
+    lcd.setCursor(0, 1);
+    lcd.print(1000 + i);
+    break;
+  case BENCH_FIELD:
+    lcd.setCursor(0, 1);
+    lcd.printField(i - 50, 6, 1);
+    break;
+  case BENCH_PRINT_F:
+    lcd.setCursor(0, 0);
+    lcd.print(F("Temp: 21.5 C"));
+    break;
+  case BENCH_CURSOR:
+    lcd.setCursor(i % 16, (i / 16) % 2);
+    break;
+  case BENCH_CLEAR:
+    lcd.clear();
+    break;
+  case BENCH_HOME:
+    lcd.home();
+    break;
+  case BENCH_CREATECHAR:
+    lcd.createChar(i & 7, glyph);
+    break;
+  case BENCH_BUTTONS:
+    lcd.readButtons();
+    break;
+  default:
+    lcd.setBacklight(i & 7);
+    break;
+  }
+}
+
+// Prints tenths as a decimal number.
+static void benchFixed(Print &out, unsigned long tenths) {
+  out.print(tenths / 10);
+  out.print('.');
+  out.print(tenths % 10);
+}
+
+static void benchHeader(Print &out) {
+  out.println(F("scenario,clock_hz,ops,us_per_op,bytes_per_op"));
+}
+
+// Runs all scenarios at the current I2C clock, which the caller has set.
+static void benchRun(RGBLCDShield_Fast &lcd, Print &out, uint32_t clock) {
+  for (uint8_t s = 0; s < BENCH_SCENARIOS; s++) {
+    uint16_t ops = benchOps(s);
+
+    lcd.clear();
+    lcd.setBacklight(0x7);
+    RGBLCDShield_Fast::resetBusStats();
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < ops; i++)
+      benchOp(lcd, s, i);
+    unsigned long us = micros() - start;
+
+    out.print(benchName(s));
+    out.print(',');
+    out.print(clock);
+    out.print(',');
+    out.print(ops);
+    out.print(',');
+    benchFixed(out, us * 10 / ops);
+    out.print(',');
+#ifdef RGBLCD_STATS
+    unsigned long bytes = 0;
+    for (uint8_t op = 0; op < LCD_OPS; op++) {
+      RGBLCDBusStats stats;
+      RGBLCDShield_Fast::busStats(op, stats);
+      bytes += stats.starts + stats.written + stats.read;
+    }
+    benchFixed(out, bytes * 10 / ops);
+#else
+    out.print('-');
+#endif
+    out.println();
+  }
+}
+
+#endif
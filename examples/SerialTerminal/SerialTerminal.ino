@@ -0,0 +1,32 @@
+/*********************
+
+Serial console on the RGB LCD shield
+
+Shows what arrives on the serial port, with cursor positioning, clearing and
+colours of the VT100 terminal, see RGBLCDTerminal.h.  For example:
+
+  printf '\033[2J\033[32mOK\r\nuptime 42 d' > /dev/ttyACM0
+
+Enable XON/XOFF flow control in the sending program for long texts.
+
+**********************/
+
+#include <Wire.h>
+#include <RGBLCDShield_Fast.h>
+#include <RGBLCDTerminal.h>
+
+RGBLCDShield_Fast lcd = RGBLCDShield_Fast();
+uint8_t screen[LCD_SHADOW_SIZE(16, 2)];
+RGBLCDTerminal terminal(lcd, screen);
+
+void setup() {
+  Serial.begin(115200);
+  lcd.begin(16, 2);
+  Wire.setClock(400000);
+  terminal.begin();
+  terminal.print(F("Waiting for\r\nserial data"));
+}
+
+void loop() {
+  terminal.update(Serial);
+}
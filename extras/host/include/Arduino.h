@@ -0,0 +1,64 @@
+/*!
+ * @file Arduino.h
+ *
+ * Minimal host replacement for the Arduino core, just enough to build the
+ * library and its examples on Linux.  In the emulator build time is
+ * simulated, see src/HostArduino.cpp: it only advances through delay(),
+ * delayMicroseconds() and I2C traffic on the emulated bus.  extras/linux
+ * provides the real clock instead.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(string_literal)                                                      \
+  (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+#define noInterrupts()
+#define interrupts()
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#include "Print.h"
+
+#endif
@@ -0,0 +1,201 @@
+/*!
+ * @file Emulator.h
+ *
+ * Cycle-approximate emulation of the hardware behind the RGB LCD shield:
+ * an I2C bus with a simulated clock, the MCP23017 port expander and the
+ * HD44780 controller wired to port B in 4-bit mode.
+ *
+ * Time only advances through bus traffic (9 bit times per byte plus START and
+ * STOP) and explicit delays, which keeps every run deterministic.
+ */
+
+#ifndef HOST_EMULATOR_H
+#define HOST_EMULATOR_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace emu {
+
+/*!
+ * @brief One transaction on the bus as seen by the devices.
+ */
+struct Transaction {
+  uint8_t addr;              //!< 7-bit slave address
+  bool read;                 //!< true for a read transfer
+  std::vector<uint8_t> data; //!< bytes after the address byte
+};
+
+/*!
+ * @brief I2C slave interface used by the emulated bus.
+ */
+class Device {
+public:
+  virtual ~Device() {}
+  virtual uint8_t address() const = 0;
+  virtual void start(bool read) = 0;
+  virtual void writeByte(uint8_t value) = 0;
+  virtual uint8_t readByte() = 0;
+  virtual void stop() = 0;
+};
+
+/*!
+ * @brief Simulated time in nanoseconds.
+ */
+uint64_t now();
+void advance(uint64_t ns);
+
+/*!
+ * @brief The shared bus: attached devices, clock rate and transaction log.
+ */
+class Bus {
+public:
+  static Bus &instance();
+
+  void attach(Device *dev);
+  void detachAll();
+
+  void setClock(uint32_t hz) { clock = hz; }
+  uint32_t getClock() const { return clock; }
+  // Fastest clock the wiring supports, 0 for no limit.  Above it every 8th
+  // byte written arrives with a flipped bit and all bytes read are garbled.
+  void setLimit(uint32_t hz) { limit = hz; }
+
+  // Returns 0 on success or 2 on address NACK, like Wire.endTransmission().
+  uint8_t write(uint8_t addr, const uint8_t *data, size_t len, bool stop);
+  // Returns the number of bytes read (0 on NACK).
+  size_t read(uint8_t addr, uint8_t *data, size_t len, bool stop);
+
+  // Bus occupancy of a given number of bit times at the current clock.
+  void bits(unsigned n);
+
+  std::vector<Transaction> log; //!< all transactions since clearLog()
+  void clearLog() { log.clear(); }
+  size_t logBytes() const;   //!< bytes (incl. address) in the log
+  size_t logStarts() const { return log.size(); }
+
+private:
+  Bus() : clock(100000), limit(0), glitch(0) {}
+  bool garbled() const { return limit != 0 && clock > limit; }
+  Device *find(uint8_t addr);
+  std::vector<Device *> devices;
+  uint32_t clock;
+  uint32_t limit;
+  unsigned glitch;
+};
+
+/*!
+ * @brief HD44780 compatible controller driven through a 4-bit interface.
+ */
+class HD44780 {
+public:
+  HD44780();
+
+  void powerOn();
+
+  // Apply new levels of the control and data lines.
+  void pins(bool rs, bool rw, bool e, uint8_t data);
+  // Data lines (D4..D7 as bits 0..3) while the controller drives the bus.
+  bool driving() const { return rwLevel && eLevel; }
+  uint8_t dataOut() const { return outNibble; }
+
+  // Screen content seen by a user: visible window of a row, honouring the
+  // display shift.
+  std::string row(uint8_t r, uint8_t cols = 16) const;
+  // Raw memories.
+  uint8_t ddram[0x80];
+  uint8_t cgram[64];
+
+  bool fourBit;
+  bool twoLine;
+  bool displayOn, cursorOn, blinkOn;
+  bool increment, shiftOnWrite;
+  uint8_t ac;          //!< address counter
+  bool cgMode;         //!< address counter points into CGRAM
+  int shift;           //!< display shift (positive = moved left)
+  uint64_t busyUntil;  //!< end of current instruction, ns
+  unsigned violations; //!< accesses while busy, RS or R/W changed with E
+  unsigned instructions, dataWrites, dataReads;
+  bool strict;         //!< count violations (default true)
+
+private:
+  void execute(uint8_t value, bool rs);
+  uint8_t readValue(bool rs);
+  void step(int dir);
+  void checkBusy();
+
+  bool rsLevel, rwLevel, eLevel;
+  uint8_t dataLevel;
+  bool highNibbleDone;
+  uint8_t pendingHigh;
+  bool readHighDone;
+  uint8_t readLatch;
+  uint8_t outNibble;
+};
+
+/*!
+ * @brief MCP23017 port expander with the shield wiring.
+ *
+ * Port A: buttons on GPA0..GPA4 (active low), red/green backlight on GPA6/7.
+ * Port B: blue backlight on GPB0, LCD D7..D4 on GPB1..GPB4, E on GPB5,
+ * RW on GPB6 and RS on GPB7.
+ */
+class MCP23017 : public Device {
+public:
+  explicit MCP23017(uint8_t addr = 0x20, HD44780 *lcd = 0);
+
+  void powerOn();
+
+  uint8_t address() const { return addr; }
+  void start(bool read);
+  void writeByte(uint8_t value);
+  uint8_t readByte();
+  void stop();
+
+  // Button levels: bit set = pressed (BUTTON_* bit layout).
+  void setButtons(uint8_t pressed);
+
+  // Canonical register file, indexed like IOCON.BANK = 0.
+  uint8_t reg[0x16];
+  bool bank() const { return reg[0x0A] & 0x80; }
+  bool seqop() const { return reg[0x0A] & 0x20; }
+
+  uint8_t pinsA() const { return levels(0); }
+  uint8_t pinsB() const { return levels(1); }
+  // Backlight colour as RED=1, GREEN=2, BLUE=4 (pins are active low).
+  uint8_t backlight() const;
+
+  unsigned registerWrites[0x16];
+  unsigned registerReads[0x16];
+
+private:
+  int decode(uint8_t a) const;
+  void next();
+  uint8_t levels(int port) const;
+  void updatePins();
+  void checkInterrupts();
+  uint8_t readReg(int r);
+
+  uint8_t addr;
+  HD44780 *lcd;
+  uint8_t pointer;
+  bool havePointer;
+  uint8_t buttons;
+  uint8_t lastInputs[2];
+};
+
+/*!
+ * @brief Convenience fixture: one shield with LCD at the given address.
+ */
+struct Shield {
+  explicit Shield(uint8_t addr = 0x20);
+  ~Shield();
+  HD44780 lcd;
+  MCP23017 mcp;
+};
+
+} // namespace emu
+
+#endif
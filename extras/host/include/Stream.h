@@ -0,0 +1,20 @@
+/*!
+ * @file Stream.h
+ *
+ * Host version of the Arduino Stream base class, without the parsing and
+ * timeout helpers.
+ */
+
+#ifndef HOST_STREAM_H
+#define HOST_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+#endif
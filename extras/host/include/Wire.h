@@ -0,0 +1,55 @@
+/*!
+ * @file Wire.h
+ *
+ * Host replacement for the Arduino Wire library.  Transactions are delivered
+ * to the devices attached to the emulated bus (see Emulator.h) and recorded
+ * so that tests can inspect the exact byte stream of every API call.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#define BUFFER_LENGTH 32
+
+class TwoWire {
+public:
+  TwoWire();
+  void begin();
+  void end();
+  void setClock(uint32_t clock);
+
+  void beginTransmission(uint8_t address);
+  void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+  uint8_t endTransmission(uint8_t sendStop);
+  uint8_t endTransmission(void) { return endTransmission(true); }
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+    return requestFrom(address, quantity, (uint8_t) true);
+  }
+  uint8_t requestFrom(int address, int quantity) {
+    return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t) true);
+  }
+
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t quantity);
+  int available(void);
+  int read(void);
+  int peek(void);
+
+private:
+  uint8_t txAddress;
+  uint8_t txBuffer[BUFFER_LENGTH];
+  uint8_t txLength;
+  bool transmitting;
+  uint8_t rxBuffer[BUFFER_LENGTH];
+  uint8_t rxIndex;
+  uint8_t rxLength;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,470 @@
+/*!
+ * @file Emulator.cpp
+ *
+ * MCP23017 and HD44780 emulation for host builds.  See Emulator.h.
+ */
+
+#include "Emulator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace emu {
+
+static uint64_t simTime = 0;
+
+uint64_t now() { return simTime; }
+void advance(uint64_t ns) { simTime += ns; }
+
+/************ bus */
+
+Bus &Bus::instance() {
+  static Bus bus;
+  return bus;
+}
+
+void Bus::attach(Device *dev) { devices.push_back(dev); }
+
+void Bus::detachAll() { devices.clear(); }
+
+Device *Bus::find(uint8_t addr) {
+  for (size_t i = 0; i < devices.size(); i++)
+    if (devices[i]->address() == addr)
+      return devices[i];
+  return 0;
+}
+
+void Bus::bits(unsigned n) {
+  advance((uint64_t)n * 1000000000ull / clock);
+}
+
+uint8_t Bus::write(uint8_t addr, const uint8_t *data, size_t len, bool stop) {
+  Transaction t;
+  t.addr = addr;
+  t.read = false;
+  Device *dev = find(addr);
+  bits(1 + 9); // START, address + ACK
+  if (dev == 0) {
+    bits(1);
+    log.push_back(t);
+    return 2;
+  }
+  dev->start(false);
+  for (size_t i = 0; i < len; i++) {
+    bits(9);
+    uint8_t value = data[i];
+    if (garbled() && ++glitch % 8 == 0)
+      value ^= 0x08;
+    dev->writeByte(value);
+    t.data.push_back(data[i]);
+  }
+  if (stop) {
+    bits(1);
+    dev->stop();
+  }
+  log.push_back(t);
+  return 0;
+}
+
+size_t Bus::read(uint8_t addr, uint8_t *data, size_t len, bool stop) {
+  Transaction t;
+  t.addr = addr;
+  t.read = true;
+  Device *dev = find(addr);
+  bits(1 + 9);
+  if (dev == 0) {
+    bits(1);
+    log.push_back(t);
+    return 0;
+  }
+  dev->start(true);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = dev->readByte();
+    if (garbled())
+      data[i] ^= 0x5a;
+    bits(9);
+    t.data.push_back(data[i]);
+  }
+  if (stop) {
+    bits(1);
+    dev->stop();
+  }
+  log.push_back(t);
+  return len;
+}
+
+size_t Bus::logBytes() const {
+  size_t n = 0;
+  for (size_t i = 0; i < log.size(); i++)
+    n += 1 + log[i].data.size();
+  return n;
+}
+
+/************ HD44780 */
+
+static const uint64_t EXEC_NS = 37000;
+static const uint64_t EXEC_SLOW_NS = 1520000;
+static const uint64_t POWER_ON_NS = 40000000;
+
+HD44780::HD44780() : strict(true) { powerOn(); }
+
+void HD44780::powerOn() {
+  memset(ddram, ' ', sizeof(ddram));
+  memset(cgram, 0, sizeof(cgram));
+  fourBit = false;
+  twoLine = false;
+  displayOn = cursorOn = blinkOn = false;
+  increment = true;
+  shiftOnWrite = false;
+  ac = 0;
+  cgMode = false;
+  shift = 0;
+  busyUntil = now() + POWER_ON_NS;
+  violations = instructions = dataWrites = dataReads = 0;
+  rsLevel = rwLevel = eLevel = false;
+  dataLevel = 0;
+  highNibbleDone = false;
+  pendingHigh = 0;
+  readHighDone = false;
+  readLatch = 0;
+  outNibble = 0;
+}
+
+void HD44780::checkBusy() {
+  if (strict && now() < busyUntil) {
+    violations++;
+    if (getenv("EMU_DEBUG"))
+      fprintf(stderr, "busy violation at %llu ns (busy until %llu)\n",
+              (unsigned long long)now(), (unsigned long long)busyUntil);
+  }
+}
+
+void HD44780::step(int dir) {
+  if (cgMode) {
+    ac = (ac + dir) & 0x3f;
+    return;
+  }
+  if (twoLine) {
+    if (dir > 0)
+      ac = (ac == 0x27) ? 0x40 : (ac == 0x67) ? 0x00 : ac + 1;
+    else
+      ac = (ac == 0x00) ? 0x67 : (ac == 0x40) ? 0x27 : ac - 1;
+  } else {
+    if (dir > 0)
+      ac = (ac >= 0x4f) ? 0x00 : ac + 1;
+    else
+      ac = (ac == 0x00) ? 0x4f : ac - 1;
+  }
+}
+
+void HD44780::execute(uint8_t value, bool rs) {
+  uint64_t t = EXEC_NS;
+  if (rs) {
+    dataWrites++;
+    if (cgMode)
+      cgram[ac & 0x3f] = value;
+    else
+      ddram[ac & 0x7f] = value;
+    step(increment ? 1 : -1);
+    if (shiftOnWrite && !cgMode)
+      shift += increment ? 1 : -1;
+  } else {
+    instructions++;
+    if (value & 0x80) {
+      ac = value & 0x7f;
+      cgMode = false;
+    } else if (value & 0x40) {
+      ac = value & 0x3f;
+      cgMode = true;
+    } else if (value & 0x20) {
+      bool four = !(value & 0x10);
+      if (four != fourBit)
+        highNibbleDone = readHighDone = false;
+      fourBit = four;
+      twoLine = value & 0x08;
+    } else if (value & 0x10) {
+      bool right = value & 0x04;
+      if (value & 0x08)
+        shift += right ? -1 : 1;
+      else
+        step(right ? 1 : -1);
+    } else if (value & 0x08) {
+      displayOn = value & 0x04;
+      cursorOn = value & 0x02;
+      blinkOn = value & 0x01;
+    } else if (value & 0x04) {
+      increment = value & 0x02;
+      shiftOnWrite = value & 0x01;
+    } else if (value & 0x02) {
+      ac = 0;
+      cgMode = false;
+      shift = 0;
+      t = EXEC_SLOW_NS;
+    } else if (value & 0x01) {
+      memset(ddram, ' ', sizeof(ddram));
+      ac = 0;
+      cgMode = false;
+      increment = true;
+      shift = 0;
+      t = EXEC_SLOW_NS;
+    }
+  }
+  shift = ((shift % 40) + 40) % 40;
+  busyUntil = now() + t;
+}
+
+uint8_t HD44780::readValue(bool rs) {
+  if (!rs)
+    return (now() < busyUntil ? 0x80 : 0x00) | (ac & 0x7f);
+  checkBusy();
+  return cgMode ? cgram[ac & 0x3f] : ddram[ac & 0x7f];
+}
+
+void HD44780::pins(bool rs, bool rw, bool e, uint8_t data) {
+  bool rising = e && !eLevel;
+  bool falling = !e && eLevel;
+  // RS and R/W need their setup time before E rises (tAS)
+  if (rising && strict && (rs != rsLevel || rw != rwLevel))
+    violations++;
+  rsLevel = rs;
+  rwLevel = rw;
+  eLevel = e;
+  dataLevel = data & 0x0f;
+
+  if (rising && rw) {
+    if (!fourBit || !readHighDone) {
+      readLatch = readValue(rs);
+      outNibble = readLatch >> 4;
+    } else {
+      outNibble = readLatch & 0x0f;
+    }
+  }
+  if (!falling)
+    return;
+
+  if (rw) {
+    if (!fourBit || readHighDone) {
+      if (rs) {
+        dataReads++;
+        step(increment ? 1 : -1);
+        busyUntil = now() + EXEC_NS;
+      }
+      readHighDone = false;
+    } else {
+      readHighDone = true;
+    }
+    return;
+  }
+
+  checkBusy();
+  if (!fourBit) {
+    // Only D4..D7 are wired; D0..D3 read as low.
+    highNibbleDone = false;
+    execute(dataLevel << 4, rs);
+  } else if (!highNibbleDone) {
+    pendingHigh = dataLevel;
+    highNibbleDone = true;
+  } else {
+    highNibbleDone = false;
+    execute((pendingHigh << 4) | dataLevel, rs);
+  }
+}
+
+std::string HD44780::row(uint8_t r, uint8_t cols) const {
+  std::string s;
+  uint8_t base = (r & 1) ? 0x40 : 0x00;
+  int first = (r >= 2) ? 20 : 0;
+  for (int c = 0; c < cols; c++) {
+    int pos = ((first + c + shift) % 40 + 40) % 40;
+    s += (char)ddram[twoLine ? base + pos : (first + c + shift) % 80];
+  }
+  return s;
+}
+
+/************ MCP23017 */
+
+// Shield wiring on port B.
+static const uint8_t PIN_RS = 0x80, PIN_RW = 0x40, PIN_E = 0x20;
+
+MCP23017::MCP23017(uint8_t a, HD44780 *l) : addr(a), lcd(l) { powerOn(); }
+
+void MCP23017::powerOn() {
+  memset(reg, 0, sizeof(reg));
+  reg[0x00] = reg[0x01] = 0xff; // IODIR
+  memset(registerWrites, 0, sizeof(registerWrites));
+  memset(registerReads, 0, sizeof(registerReads));
+  pointer = 0;
+  havePointer = false;
+  buttons = 0;
+  lastInputs[0] = levels(0);
+  lastInputs[1] = levels(1);
+  updatePins();
+}
+
+int MCP23017::decode(uint8_t a) const {
+  if (!bank())
+    return a < 0x16 ? a : -1;
+  if (a <= 0x0a)
+    return a * 2;
+  if (a >= 0x10 && a <= 0x1a)
+    return (a - 0x10) * 2 + 1;
+  return -1;
+}
+
+void MCP23017::next() {
+  if (seqop()) {
+    if (!bank())
+      pointer ^= 1; // byte mode toggles between A/B pairs
+    return;
+  }
+  pointer++;
+  if (!bank()) {
+    if (pointer >= 0x16)
+      pointer = 0;
+  } else if (pointer == 0x0b) {
+    pointer = 0x10;
+  } else if (pointer >= 0x1b) {
+    pointer = 0;
+  }
+}
+
+uint8_t MCP23017::levels(int port) const {
+  uint8_t iodir = reg[port];
+  uint8_t level = reg[0x14 + port] & ~iodir;
+  // Port A inputs float high; port B inputs need the pull-ups, otherwise
+  // the LCD control lines would see spurious edges.
+  uint8_t ext = port ? reg[0x0c + port] : 0xff;
+  if (port == 0) {
+    ext &= ~buttons;
+  } else if (lcd && lcd->driving()) {
+    uint8_t d = lcd->dataOut();
+    ext &= ~0x1e;
+    if (d & 0x1) ext |= 0x10; // D4
+    if (d & 0x2) ext |= 0x08; // D5
+    if (d & 0x4) ext |= 0x04; // D6
+    if (d & 0x8) ext |= 0x02; // D7
+  }
+  return level | (ext & iodir);
+}
+
+uint8_t MCP23017::backlight() const {
+  uint8_t a = levels(0), b = levels(1);
+  uint8_t c = 0;
+  if (!(a & 0x40)) c |= 0x1;
+  if (!(a & 0x80)) c |= 0x2;
+  if (!(b & 0x01)) c |= 0x4;
+  return c;
+}
+
+void MCP23017::updatePins() {
+  if (lcd) {
+    uint8_t b = levels(1);
+    uint8_t d = 0;
+    if (b & 0x10) d |= 0x1;
+    if (b & 0x08) d |= 0x2;
+    if (b & 0x04) d |= 0x4;
+    if (b & 0x02) d |= 0x8;
+    lcd->pins(b & PIN_RS, b & PIN_RW, b & PIN_E, d);
+  }
+  checkInterrupts();
+}
+
+void MCP23017::checkInterrupts() {
+  for (int port = 0; port < 2; port++) {
+    uint8_t now = levels(port);
+    uint8_t en = reg[0x04 + port];
+    uint8_t intcon = reg[0x08 + port];
+    uint8_t changed = (now ^ lastInputs[port]) & ~intcon;
+    uint8_t differs = (now ^ reg[0x06 + port]) & intcon;
+    uint8_t fire = (changed | differs) & en & reg[port];
+    if (fire && reg[0x0e + port] == 0) {
+      reg[0x0e + port] = fire;
+      reg[0x10 + port] = now;
+    }
+    lastInputs[port] = now;
+  }
+}
+
+void MCP23017::setButtons(uint8_t pressed) {
+  buttons = pressed & 0x1f;
+  checkInterrupts();
+}
+
+void MCP23017::start(bool read) {
+  if (!read)
+    havePointer = false;
+}
+
+void MCP23017::writeByte(uint8_t value) {
+  if (!havePointer) {
+    pointer = value;
+    havePointer = true;
+    return;
+  }
+  int r = decode(pointer);
+  if (r >= 0) {
+    registerWrites[r]++;
+    switch (r) {
+    case 0x0a:
+    case 0x0b:
+      reg[0x0a] = reg[0x0b] = value & 0xfe;
+      break;
+    case 0x0e:
+    case 0x0f:
+    case 0x10:
+    case 0x11:
+      break; // read-only
+    case 0x12:
+    case 0x13:
+      reg[r + 2] = value; // GPIO writes go to OLAT
+      break;
+    default:
+      reg[r] = value;
+    }
+    updatePins();
+  }
+  next();
+}
+
+uint8_t MCP23017::readReg(int r) {
+  if (r < 0)
+    return 0;
+  registerReads[r]++;
+  int port = r & 1;
+  switch (r) {
+  case 0x12:
+  case 0x13: {
+    uint8_t v = levels(port);
+    v ^= reg[0x02 + port] & reg[port];
+    reg[0x0e + port] = 0;
+    checkInterrupts();
+    return v;
+  }
+  case 0x10:
+  case 0x11: {
+    uint8_t v = reg[r];
+    reg[0x0e + port] = 0;
+    checkInterrupts();
+    return v;
+  }
+  default:
+    return reg[r];
+  }
+}
+
+uint8_t MCP23017::readByte() {
+  uint8_t v = readReg(decode(pointer));
+  next();
+  return v;
+}
+
+void MCP23017::stop() {}
+
+Shield::Shield(uint8_t addr) : lcd(), mcp(addr, &lcd) {
+  Bus::instance().attach(&mcp);
+}
+
+Shield::~Shield() { Bus::instance().detachAll(); }
+
+} // namespace emu
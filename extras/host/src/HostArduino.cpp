@@ -0,0 +1,17 @@
+/*!
+ * @file HostArduino.cpp
+ *
+ * Host implementation of the Arduino timing functions on the simulated
+ * clock of the emulator.
+ */
+
+#include "Arduino.h"
+#include "Emulator.h"
+
+unsigned long millis(void) { return (unsigned long)(emu::now() / 1000000ull); }
+
+unsigned long micros(void) { return (unsigned long)(emu::now() / 1000ull); }
+
+void delay(unsigned long ms) { emu::advance((uint64_t)ms * 1000000ull); }
+
+void delayMicroseconds(unsigned int us) { emu::advance((uint64_t)us * 1000ull); }
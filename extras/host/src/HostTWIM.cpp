@@ -0,0 +1,108 @@
+/*!
+ * @file HostTWIM.cpp
+ *
+ * Host TWIMaster on top of the emulated bus, for the tests of the transmit
+ * queue (RGBLCD_TWI_ASYNC).  In place of the interrupt, the queued frames go
+ * out in one transaction when the queue has no room left or the program
+ * waits for it, so tests can fill the queue deterministically.
+ */
+
+#include <RGBLCDShield_Fast_config.h>
+
+#ifdef RGBLCD_TWI_ASYNC
+
+#include <utility/TWIMaster.h>
+#include <vector>
+
+#include "Emulator.h"
+
+TWIMaster TWIM;
+
+static TWIQueue q;
+static uint8_t q_addr, q_reg;
+static uint8_t txAddress;
+static std::vector<uint8_t> txBuffer;
+
+// Does what the interrupt would do in the meantime.
+static void drain() {
+  if (q.count == 0)
+    return;
+  std::vector<uint8_t> data(1, q_reg);
+  uint8_t frame[TWI_FRAME_MAX];
+  while (q.count != 0) {
+    uint8_t len = q.pop(frame);
+    data.insert(data.end(), frame, frame + len);
+  }
+  emu::Bus::instance().write(q_addr, data.data(), data.size(), true);
+}
+
+TWIMaster::TWIMaster() : status(0), twcr(0), rxIndex(0), rxLength(0) {}
+
+void TWIMaster::begin() {}
+
+void TWIMaster::setClock(uint32_t clock) {
+  waitIdle();
+  emu::Bus::instance().setClock(clock);
+}
+
+void TWIMaster::beginTransmission(uint8_t address) {
+  waitIdle();
+  txAddress = address;
+  txBuffer.clear();
+}
+
+size_t TWIMaster::write(uint8_t data) {
+  txBuffer.push_back(data);
+  return 1;
+}
+
+size_t TWIMaster::write(const uint8_t *data, size_t quantity) {
+  txBuffer.insert(txBuffer.end(), data, data + quantity);
+  return quantity;
+}
+
+uint8_t TWIMaster::endTransmission() {
+  return emu::Bus::instance().write(txAddress, txBuffer.data(),
+                                    txBuffer.size(), true);
+}
+
+uint8_t TWIMaster::requestFrom(uint8_t address, uint8_t quantity) {
+  if (quantity > sizeof(rxBuffer))
+    quantity = sizeof(rxBuffer);
+  waitIdle();
+  rxIndex = 0;
+  rxLength = emu::Bus::instance().read(address, rxBuffer, quantity, true);
+  return rxLength;
+}
+
+int TWIMaster::read() {
+  if (rxIndex < rxLength)
+    return rxBuffer[rxIndex++];
+  return -1;
+}
+
+bool TWIMaster::queue(uint8_t address, uint8_t reg, const uint8_t *frame,
+                      uint8_t len, uint8_t flags, uint8_t policy) {
+  if (address != q_addr || reg != q_reg) {
+    waitIdle();
+    q_addr = address;
+    q_reg = reg;
+  }
+  while (q.room() < len + 1) {
+    if (policy == TWI_QUEUE_SHORT)
+      return false;
+    if (policy != TWI_QUEUE_DROP_OLDEST || !q.drop())
+      drain();
+  }
+  q.write(frame, len, flags);
+  q.commit(len);
+  return true;
+}
+
+bool TWIMaster::busy() { return q.count != 0; }
+
+uint8_t TWIMaster::pending() { return q.count; }
+
+void TWIMaster::waitIdle() { drain(); }
+
+#endif
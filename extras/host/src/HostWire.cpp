@@ -0,0 +1,73 @@
+/*!
+ * @file HostWire.cpp
+ *
+ * Host Wire implementation on top of the emulated bus.  Like the AVR
+ * version, write() refuses bytes once the 32-byte buffer is full.
+ */
+
+#include "Wire.h"
+#include "Emulator.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+    : txAddress(0), txLength(0), transmitting(false), rxIndex(0),
+      rxLength(0) {}
+
+void TwoWire::begin() {}
+
+void TwoWire::end() {}
+
+void TwoWire::setClock(uint32_t clock) { emu::Bus::instance().setClock(clock); }
+
+void TwoWire::beginTransmission(uint8_t address) {
+  transmitting = true;
+  txAddress = address;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (!transmitting || txLength >= BUFFER_LENGTH)
+    return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+  size_t n = 0;
+  while (quantity-- && write(*data++))
+    n++;
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop) {
+  uint8_t ret =
+      emu::Bus::instance().write(txAddress, txBuffer, txLength, sendStop);
+  txLength = 0;
+  transmitting = false;
+  return ret;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity,
+                             uint8_t sendStop) {
+  if (quantity > BUFFER_LENGTH)
+    quantity = BUFFER_LENGTH;
+  rxIndex = 0;
+  rxLength =
+      emu::Bus::instance().read(address, rxBuffer, quantity, sendStop);
+  return rxLength;
+}
+
+int TwoWire::available(void) { return rxLength - rxIndex; }
+
+int TwoWire::read(void) {
+  if (rxIndex < rxLength)
+    return rxBuffer[rxIndex++];
+  return -1;
+}
+
+int TwoWire::peek(void) {
+  if (rxIndex < rxLength)
+    return rxBuffer[rxIndex];
+  return -1;
+}
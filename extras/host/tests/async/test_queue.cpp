@@ -0,0 +1,97 @@
+/*!
+ * @file test_queue.cpp
+ *
+ * Transmit queue of RGBLCD_TWI_ASYNC: the host TWIMaster only sends the
+ * queued frames when the queue is full or the program waits for it.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+#include <string>
+
+static const char text[] = "0123456789ABCDEFGHIJ";
+
+TEST(queue_block_keeps_everything) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setAsync(true);
+  lcd.setCursor(2, 1);
+  lcd.print("0123456789ABCD");
+  CHECK(lcd.pending() > 0);
+  lcd.waitIdle();
+  CHECK_STR(shield.lcd.row(1), "  0123456789ABCD");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(queue_drop_oldest_keeps_commands) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setAsync(true);
+  lcd.setQueuePolicy(LCD_QUEUE_DROP_OLDEST);
+
+  // The queue fills up behind the address command: the oldest characters
+  // go, the command stays.
+  lcd.setCursor(0, 1);
+  lcd.print(text);
+  lcd.waitIdle();
+  CHECK_STR(shield.lcd.row(0), "                ");
+  std::string row = shield.lcd.row(1);
+  size_t n = row.find(' ');
+  CHECK(n > 0 && n < sizeof(text) - 1);
+  CHECK_STR(row.substr(0, n), text + sizeof(text) - 1 - n);
+
+  // A command between the characters stays as well, the characters
+  // before it go first.
+  lcd.clear();
+  lcd.print("ab");
+  lcd.setCursor(4, 1);
+  lcd.print(text);
+  lcd.waitIdle();
+  CHECK_STR(shield.lcd.row(0), "                ");
+  row = shield.lcd.row(1);
+  n = row.find(' ', 4) - 4;
+  CHECK_STR(row.substr(0, 4), "    ");
+  CHECK(n > 0 && n < sizeof(text) - 1);
+  CHECK_STR(row.substr(4, n), text + sizeof(text) - 1 - n);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(queue_drop_oldest_keeps_the_rs_setup) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setAsync(true);
+  lcd.setQueuePolicy(LCD_QUEUE_DROP_OLDEST);
+
+  // Commands fill the queue, the character behind them is the only one to
+  // drop.  The next character relies on its change of RS.
+  for (int i = 0; i < 11; i++)
+    lcd.display();
+  lcd.print("x");
+  lcd.print("y");
+  lcd.waitIdle();
+  CHECK_STR(shield.lcd.row(0), "y               ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(queue_short_field_stops_at_the_first_refusal) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setAsync(true);
+  lcd.setQueuePolicy(LCD_QUEUE_SHORT);
+
+  // Only part of the field fits behind the text: it is cut off, not holed.
+  lcd.print("abcdefgh");
+  size_t n = lcd.printField(-1234, 6, 2);
+  CHECK(n > 0 && n < 6);
+  lcd.waitIdle();
+  std::string want = std::string("abcdefgh") + std::string("-12.34", n);
+  want.resize(16, ' ');
+  CHECK_STR(shield.lcd.row(0), want);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
@@ -0,0 +1,102 @@
+/*!
+ * @file test_linux_i2c.cpp
+ *
+ * i2c-dev transport: the ioctls are handed to the emulated bus, so the
+ * tests see both the number of system calls and the resulting screen.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+#include <utility/LinuxI2C.h>
+
+static unsigned long ioctls;
+static unsigned long messages;
+
+// Plays the messages of one I2C_RDWR ioctl on the emulated bus, with a
+// repeated START between them and a STOP at the end.
+static int emulated(int fd, struct i2c_msg *msgs, unsigned count) {
+  emu::Bus &bus = emu::Bus::instance();
+  ioctls++;
+  for (unsigned i = 0; i < count; i++) {
+    bool stop = i + 1 == count;
+    messages++;
+    if (msgs[i].flags & I2C_M_RD) {
+      if (bus.read(msgs[i].addr, msgs[i].buf, msgs[i].len, stop) != msgs[i].len)
+        return -1;
+    } else if (bus.write(msgs[i].addr, msgs[i].buf, msgs[i].len, stop) != 0) {
+      return -1;
+    }
+  }
+  return count;
+}
+
+struct Fixture {
+  Fixture() {
+    LinuxWire.setTransfer(emulated);
+    ioctls = messages = 0;
+  }
+  ~Fixture() { LinuxWire.setTransfer(NULL); }
+};
+
+TEST(linux_full_screen_in_one_ioctl) {
+  Fixture f;
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  const char text[] = "0123456789abcdefghijklmnopqrstuvwxyz0123";
+  ioctls = 0;
+  emu::Bus::instance().clearLog();
+  lcd.write((const uint8_t *)text, 40);
+  CHECK_EQ(ioctls, 1);
+  CHECK_EQ(emu::Bus::instance().logStarts(), 1);
+  CHECK_STR(shield.lcd.row(0), "0123456789abcdef");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(linux_register_read_in_one_ioctl) {
+  Fixture f;
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  shield.mcp.setButtons(BUTTON_UP);
+  ioctls = messages = 0;
+  CHECK_EQ(lcd.readButtons(), BUTTON_UP);
+  CHECK_EQ(ioctls, 1);
+  CHECK_EQ(messages, 2); // register pointer, repeated START, one byte read
+}
+
+TEST(linux_display_works_end_to_end) {
+  Fixture f;
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  lcd.setBacklight(0x2);
+  uint8_t glyph[8] = {1, 2, 4, 8, 16, 8, 4, 2};
+  lcd.createChar(1, glyph);
+  lcd.setCursor(3, 1);
+  lcd.print("pi");
+  lcd.write(1);
+  CHECK_STR(shield.lcd.row(1), "   pi\x01          ");
+  CHECK_EQ(shield.lcd.cgram[8 + 3], 8);
+  CHECK_EQ(shield.mcp.backlight(), 0x2);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(linux_device_errors) {
+  LinuxI2C dev;
+  CHECK(!dev.begin("/nonexistent/i2c-7"));
+
+  // A file which is no I2C adapter: the ioctl fails.
+  CHECK(dev.begin("/dev/null"));
+  dev.beginTransmission(0x20);
+  dev.write(0x19);
+  dev.write(0x00);
+  CHECK_EQ(dev.endTransmission(), 4);
+  CHECK_EQ(dev.requestFrom(0x20, 1), 0);
+  CHECK_EQ(dev.transfers(), 2);
+}
@@ -0,0 +1,60 @@
+/*!
+ * @file main.cpp
+ *
+ * Runs all registered host tests.
+ */
+
+#include "test.h"
+
+namespace test {
+
+Case *&registry() {
+  static Case *head = 0;
+  return head;
+}
+
+int &failures() {
+  static int n = 0;
+  return n;
+}
+
+std::string hex(const std::vector<uint8_t> &v) {
+  std::string s;
+  char buf[4];
+  for (size_t i = 0; i < v.size(); i++) {
+    snprintf(buf, sizeof(buf), i ? " %02x" : "%02x", v[i]);
+    s += buf;
+  }
+  return s;
+}
+
+} // namespace test
+
+int main(int argc, char **argv) {
+  // Registration prepends, so reverse to run in file order.
+  test::Case *list = 0;
+  for (test::Case *c = test::registry(); c;) {
+    test::Case *n = c->next;
+    c->next = list;
+    list = c;
+    c = n;
+  }
+  int run = 0, failed = 0;
+  for (test::Case *c = list; c; c = c->next) {
+    if (argc > 1 && std::string(argv[1]) != c->name)
+      continue;
+    int before = test::failures();
+    emu::Bus::instance().detachAll();
+    emu::Bus::instance().clearLog();
+    emu::Bus::instance().setClock(100000);
+    emu::Bus::instance().setLimit(0);
+    c->func();
+    run++;
+    bool ok = test::failures() == before;
+    if (!ok)
+      failed++;
+    printf("%s %s\n", ok ? "PASS" : "FAIL", c->name);
+  }
+  printf("%d tests, %d failed\n", run, failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+/*!
+ * @file test.h
+ *
+ * Tiny self-registering test harness for the host build.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <string>
+
+#include "Emulator.h"
+
+namespace test {
+
+typedef void (*Func)();
+
+struct Case {
+  const char *name;
+  Func func;
+  Case *next;
+};
+
+Case *&registry();
+int &failures();
+
+struct Register {
+  Register(Case *c) {
+    c->next = registry();
+    registry() = c;
+  }
+};
+
+// Bytes as two-digit hex numbers separated by spaces, e.g. "19 a4 84".
+std::string hex(const std::vector<uint8_t> &v);
+
+} // namespace test
+
+#define TEST(name)                                                             \
+  static void test_##name();                                                   \
+  static test::Case case_##name = {#name, test_##name, 0};                     \
+  static test::Register reg_##name(&case_##name);                              \
+  static void test_##name()
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);        \
+      test::failures()++;                                                      \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long va_ = (long long)(a), vb_ = (long long)(b);                      \
+    if (va_ != vb_) {                                                          \
+      printf("  %s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__,     \
+             __LINE__, #a, #b, va_, vb_);                                      \
+      test::failures()++;                                                      \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_STR(a, b)                                                        \
+  do {                                                                         \
+    std::string va_(a), vb_(b);                                                \
+    if (va_ != vb_) {                                                          \
+      printf("  %s:%d: CHECK_STR(%s, %s) failed: \"%s\" != \"%s\"\n",          \
+             __FILE__, __LINE__, #a, #b, va_.c_str(), vb_.c_str());            \
+      test::failures()++;                                                      \
+    }                                                                          \
+  } while (0)
+
+#endif
@@ -0,0 +1,132 @@
+/*!
+ * @file test_backlight.cpp
+ *
+ * Lazy backlight updates and the non-blocking backlight effects.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDBacklight.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(lazy_backlight_rides_on_lcd_transfer) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  CHECK_EQ(shield.mcp.backlight(), 0x7);
+
+  // blue is on port B: no transfer until the next character
+  bus.clearLog();
+  lcd.setBacklight(0x3, true);
+  CHECK_EQ(bus.logStarts(), 0);
+  CHECK_EQ(shield.mcp.backlight(), 0x7);
+  lcd.print("a");
+  CHECK_EQ(bus.logStarts(), 1);
+  CHECK_EQ(bus.logBytes(), 2u + 5);
+  CHECK_EQ(shield.mcp.backlight(), 0x3);
+
+  // red is on port A: a single write
+  bus.clearLog();
+  lcd.setBacklight(0x2, true);
+  CHECK_EQ(bus.logStarts(), 1);
+  CHECK_EQ(shield.mcp.backlight(), 0x2);
+
+  // the blue LED was carried already, setting it again is free
+  bus.clearLog();
+  lcd.setBacklight(0x2);
+  CHECK_EQ(bus.logStarts(), 0);
+  CHECK_STR(shield.lcd.row(0), "a               ");
+}
+
+TEST(backlight_blink_without_lcd_traffic) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDBacklight light(lcd);
+
+  light.blink(0x1, 0x4, 100);
+  CHECK(light.running());
+  for (int t = 0; t < 50; t++) {
+    delay(1);
+    light.update();
+  }
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+  for (int t = 0; t < 100; t++) {
+    delay(1);
+    light.update();
+  }
+  CHECK_EQ(shield.mcp.backlight(), 0x4);
+  for (int t = 0; t < 100; t++) {
+    delay(1);
+    light.update();
+  }
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+
+  light.stop();
+  CHECK(!light.running());
+  delay(200);
+  light.update();
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+}
+
+TEST(backlight_blink_costs_no_port_b_writes_while_printing) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDBacklight light(lcd);
+
+  bus.clearLog();
+  light.blink(0x7, 0x3, 50);
+  size_t separate = 0;
+  for (int t = 0; t < 500; t++) {
+    size_t before = bus.logStarts();
+    light.update();
+    separate += bus.logStarts() - before;
+    lcd.setCursor(0, 0);
+    lcd.print(t);
+    delay(1);
+  }
+  CHECK_EQ(separate, 0);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(backlight_fade_and_sequence) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDBacklight light(lcd);
+
+  // The share of the new colour grows over the fade.
+  light.fade(0x0, 0x1, 800);
+  int early = 0, late = 0;
+  for (int t = 0; t < 800; t++) {
+    light.update();
+    if (t < 200)
+      early += shield.mcp.backlight() == 0x1;
+    else if (t >= 600)
+      late += shield.mcp.backlight() == 0x1;
+    delay(1);
+  }
+  CHECK(early < 60);
+  CHECK(late > 140);
+  delay(50);
+  light.update();
+  CHECK(!light.running());
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+
+  static const RGBLCDStep steps[] = {
+      {0x2, false, 30}, {0x6, false, 30}, {0x5, false, 30}};
+  light.play(steps, 3);
+  for (int t = 0; t < 120; t++) {
+    light.update();
+    delay(1);
+  }
+  CHECK(!light.running());
+  light.update();
+  delay(RGBLCD_BACKLIGHT_LAG_MS);
+  light.update();
+  CHECK_EQ(shield.mcp.backlight(), 0x5);
+}
@@ -0,0 +1,125 @@
+/*!
+ * @file test_bars.cpp
+ *
+ * Incremental bar graphs.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDBars.h>
+#include <RGBLCDShield_Fast.h>
+
+// Characters written to DDRAM and rows written to CGRAM since clearLog(),
+// decoded from the nibbles on the bus.
+struct Writes {
+  int ddram, cgram;
+};
+
+static Writes writes(RGBLCDShield_Fast &lcd, emu::Shield &shield,
+                     uint8_t *before_cgram, uint8_t *before_ddram) {
+  Writes w = {0, 0};
+  for (int i = 0; i < 64; i++)
+    w.cgram += shield.lcd.cgram[i] != before_cgram[i];
+  for (int i = 0; i < 0x80; i++)
+    w.ddram += shield.lcd.ddram[i] != before_ddram[i];
+  return w;
+}
+
+TEST(hbar_moves_by_one_cell_write) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDHBar bar(lcd, 2, 1, 10);
+  bar.begin();
+  CHECK_STR(shield.lcd.row(1), "                ");
+
+  bar.set(23);
+  for (int i = 0; i < 4; i++)
+    CHECK_EQ(shield.lcd.ddram[0x42 + i], 0xff);
+  CHECK_EQ(shield.lcd.ddram[0x46], 4 + 2); // three columns
+  CHECK_EQ(shield.lcd.cgram[(4 + 2) * 8], 0x1c);
+
+  // one pixel: one character, 2 + 5 + 5 bytes with the address command.
+  // 26 pixels start a new cell right at the address counter, 2 + 4 bytes.
+  for (int px = 24; px <= 26; px++) {
+    bus.clearLog();
+    bar.set(px);
+    CHECK_EQ(bus.logStarts(), 1);
+    CHECK_EQ(bus.logBytes(), (px == 26) ? 2u + 4 : 2u + 5 + 5);
+  }
+  CHECK_EQ(shield.lcd.ddram[0x46], 0xff);
+  CHECK_EQ(shield.lcd.ddram[0x47], 4);
+
+  bar.set(3);
+  CHECK_EQ(shield.lcd.ddram[0x42], 4 + 2);
+  for (int i = 1; i < 10; i++)
+    CHECK_EQ(shield.lcd.ddram[0x42 + i], ' ');
+  bus.clearLog();
+  bar.set(3);
+  CHECK_EQ(bus.logStarts(), 0);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(bars_default_slots_do_not_overlap) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDHBar hbar(lcd, 0, 0, 10);
+  RGBLCDVBar vbar(lcd, 15, 1, 1);
+  hbar.begin();
+  vbar.begin();
+  hbar.set(7);
+  uint8_t cg[32];
+  memcpy(cg, shield.lcd.cgram + 32, 32); // slots 4..7
+  vbar.set(3);
+  CHECK(memcmp(shield.lcd.cgram + 32, cg, 32) == 0);
+  const uint8_t three[8] = {0, 0, 0, 0, 0, 0x1f, 0x1f, 0x1f};
+  CHECK(memcmp(shield.lcd.cgram + 24, three, 8) == 0);
+  hbar.set(8);
+  CHECK(memcmp(shield.lcd.cgram + 24, three, 8) == 0);
+  CHECK_EQ(shield.lcd.ddram[0x4f], 3);
+}
+
+TEST(vbar_moves_by_one_cgram_row) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDVBar bar(lcd, 15, 1, 2, 7);
+  bar.begin();
+  bar.set(3);
+  CHECK_EQ(shield.lcd.ddram[0x4f], 7);
+  CHECK_EQ(shield.lcd.ddram[0x0f], ' ');
+  const uint8_t three[8] = {0, 0, 0, 0, 0, 0x1f, 0x1f, 0x1f};
+  CHECK(memcmp(shield.lcd.cgram + 56, three, 8) == 0);
+
+  uint8_t cg[64], dd[0x80];
+  memcpy(cg, shield.lcd.cgram, 64);
+  memcpy(dd, shield.lcd.ddram, 0x80);
+  bar.set(4);
+  Writes w = writes(lcd, shield, cg, dd);
+  CHECK_EQ(w.cgram, 1);
+  CHECK_EQ(w.ddram, 0);
+  CHECK_EQ(shield.lcd.cgram[56 + 4], 0x1f);
+
+  // into the upper cell
+  bar.set(10);
+  CHECK_EQ(shield.lcd.ddram[0x4f], 0xff);
+  CHECK_EQ(shield.lcd.ddram[0x0f], 7);
+  const uint8_t two[8] = {0, 0, 0, 0, 0, 0, 0x1f, 0x1f};
+  CHECK(memcmp(shield.lcd.cgram + 56, two, 8) == 0);
+
+  bar.set(16);
+  CHECK_EQ(shield.lcd.ddram[0x0f], 0xff);
+  bar.set(0);
+  CHECK_EQ(shield.lcd.ddram[0x4f], 7);
+  CHECK_EQ(shield.lcd.ddram[0x0f], ' ');
+  CHECK_EQ(shield.lcd.cgram[63], 0);
+
+  // the LCD is back in DDRAM mode
+  lcd.setCursor(0, 0);
+  lcd.print("ok");
+  CHECK_EQ(shield.lcd.ddram[0], 'o');
+  CHECK_EQ(shield.lcd.violations, 0);
+}
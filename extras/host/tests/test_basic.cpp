@@ -0,0 +1,54 @@
+/*!
+ * @file test_basic.cpp
+ *
+ * Baseline behaviour of the driver against the emulator.
+ */
+
+#include "test.h"
+
+#include <RGBLCDShield_Fast.h>
+
+TEST(begin_and_print) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.print("Hello, world!");
+  lcd.setCursor(0, 1);
+  lcd.print(1234);
+  CHECK_STR(shield.lcd.row(0), "Hello, world!   ");
+  CHECK_STR(shield.lcd.row(1), "1234            ");
+  CHECK(shield.lcd.displayOn);
+  CHECK(shield.lcd.twoLine);
+  CHECK_EQ(shield.lcd.violations, 0);
+  CHECK_EQ(shield.mcp.backlight(), 0x7);
+}
+
+TEST(clear_waits_for_busy_flag) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.print("xyz");
+  lcd.clear();
+  lcd.print("ab");
+  CHECK_STR(shield.lcd.row(0), "ab              ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(create_char_fills_cgram) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  uint8_t glyph[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  lcd.createChar(2, glyph);
+  CHECK(memcmp(shield.lcd.cgram + 16, glyph, 8) == 0);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(read_buttons) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  CHECK_EQ(lcd.readButtons(), 0);
+  shield.mcp.setButtons(BUTTON_UP | BUTTON_SELECT);
+  CHECK_EQ(lcd.readButtons(), BUTTON_UP | BUTTON_SELECT);
+}
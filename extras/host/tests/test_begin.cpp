@@ -0,0 +1,77 @@
+/*!
+ * @file test_begin.cpp
+ *
+ * Cold and warm start of begin().
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+static uint64_t boot(emu::Shield &shield) {
+  RGBLCDShield_Fast lcd;
+  uint64_t t = emu::now();
+  lcd.begin(16, 2);
+  lcd.print("boot");
+  t = emu::now() - t;
+  CHECK_STR(shield.lcd.row(0), "boot            ");
+  CHECK_EQ(shield.lcd.violations, 0);
+  CHECK_EQ(shield.mcp.backlight(), 0x7);
+  return t;
+}
+
+static void warmStart(uint32_t clock) {
+  emu::Shield shield;
+  emu::Bus::instance().setClock(clock);
+  emu::advance(100000000ull); // past the power-on time of the LCD
+  uint64_t cold = boot(shield);
+
+  // The MCU restarts, the shield keeps its power and state.
+  uint64_t warm = boot(shield);
+  CHECK(cold > 59000000ull);
+  CHECK(warm < cold / 4);
+  if (getenv("EMU_DEBUG"))
+    printf("  %lu Hz: cold %lu us, warm %lu us\n", (unsigned long)clock,
+           (unsigned long)(cold / 1000), (unsigned long)(warm / 1000));
+}
+
+TEST(warm_start_skips_power_on_delays) {
+  warmStart(100000);
+  warmStart(400000);
+}
+
+TEST(warm_start_with_fresh_lcd_does_full_init) {
+  emu::Shield shield;
+  emu::advance(100000000ull);
+  boot(shield);
+
+  // Only the LCD lost power: it is back in 8 bit mode.
+  shield.lcd.powerOn();
+  emu::advance(100000000ull);
+  uint64_t t = boot(shield);
+  CHECK(t > 59000000ull);
+}
+
+TEST(warm_start_out_of_nibble_sync_does_full_init) {
+  emu::Shield shield;
+  emu::advance(100000000ull);
+  boot(shield);
+
+  // The MCU was reset after the first half of a byte.
+  const uint8_t half[] = {MCP23017_BANK_GPIOB, 0x80 | 0x20 | 0x04,
+                          0x80 | 0x04};
+  emu::Bus::instance().write(MCP23017_ADDRESS, half, sizeof(half), true);
+  uint64_t t = boot(shield);
+  CHECK(t > 59000000ull);
+}
+
+TEST(cold_start_of_expander) {
+  emu::Shield shield;
+  boot(shield);
+  CHECK(shield.mcp.bank());
+  CHECK(shield.mcp.seqop());
+  CHECK_EQ(shield.mcp.reg[0x00], 0x3f); // IODIRA: buttons and unused GPA5
+  CHECK_EQ(shield.mcp.reg[0x0C], 0x1f); // GPPUA
+  CHECK_EQ(shield.mcp.reg[0x01], 0x00); // IODIRB
+}
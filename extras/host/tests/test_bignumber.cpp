@@ -0,0 +1,60 @@
+/*!
+ * @file test_bignumber.cpp
+ *
+ * Large digits which only send the cells that change.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDBigNumber.h>
+#include <RGBLCDShield_Fast.h>
+
+// The number as drawn, one character per cell: '#' full block, '^' upper
+// bar, '_' lower bar, '=' both.
+static std::string cells(emu::Shield &shield, uint8_t row) {
+  std::string s;
+  for (int col = 0; col < 16; col++) {
+    uint8_t c = shield.lcd.ddram[(row ? 0x40 : 0) + col];
+    s += (c == 0xff) ? '#' : (c == 0) ? '^' : (c == 1) ? '_' : (c == 2) ? '=' : c;
+  }
+  return s;
+}
+
+TEST(big_number_draws_digits) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDBigNumber number(lcd, 0, 0, 4);
+  number.begin();
+  CHECK_EQ(shield.lcd.cgram[0], 0x1f);
+  CHECK_EQ(shield.lcd.cgram[15], 0x1f);
+
+  number.set(-208);
+  CHECK_STR(cells(shield, 0), "___ ==# #^# #=# ");
+  CHECK_STR(cells(shield, 1), "    #__ #_# #_# ");
+  number.set(12345); // does not fit
+  CHECK_STR(cells(shield, 0), "                ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(big_number_sends_only_changed_cells) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDBigNumber number(lcd, 0, 0, 4);
+  number.begin();
+  number.set(1998);
+
+  // 1998 -> 1999: a single cell of the last digit differs
+  bus.clearLog();
+  number.set(1999);
+  CHECK_EQ(bus.logStarts(), 1);
+  CHECK_EQ(bus.logBytes(), 2u + 5 + 5);
+  CHECK_STR(cells(shield, 1), "_#_ __# __# __# ");
+
+  bus.clearLog();
+  number.set(1999);
+  CHECK_EQ(bus.logStarts(), 0);
+}
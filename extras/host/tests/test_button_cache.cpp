@@ -0,0 +1,77 @@
+/*!
+ * @file test_button_cache.cpp
+ *
+ * Cached button state, refreshed while the display waits for the LCD.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(button_cache_serves_fresh_samples) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setButtonCache(100);
+
+  shield.mcp.setButtons(BUTTON_DOWN);
+  bus.clearLog();
+  CHECK_EQ(lcd.readButtons(), BUTTON_DOWN);
+  CHECK_EQ(bus.logStarts(), 2);
+  shield.mcp.setButtons(0);
+  CHECK_EQ(lcd.readButtons(), BUTTON_DOWN); // still cached
+  CHECK_EQ(bus.logStarts(), 2);
+  delay(100);
+  CHECK_EQ(lcd.readButtons(), 0);
+  CHECK_EQ(bus.logStarts(), 4);
+
+  // disabled: every call reads the port
+  lcd.setButtonCache(0);
+  bus.clearLog();
+  lcd.readButtons();
+  lcd.readButtons();
+  CHECK_EQ(bus.logStarts(), 4);
+}
+
+TEST(button_cache_sampled_during_clear) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setButtonCache(50);
+  delay(60);
+
+  shield.mcp.setButtons(BUTTON_RIGHT);
+  lcd.print("abc");
+  lcd.clear();
+  CHECK(lcd.buttonAge() < 5);
+  bus.clearLog();
+  CHECK_EQ(lcd.readButtons(), BUTTON_RIGHT);
+  CHECK_EQ(bus.logStarts(), 0);
+
+  lcd.print("x");
+  CHECK_STR(shield.lcd.row(0), "x               ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(button_cache_sampled_during_deferred_clear) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setDeferred(true);
+  lcd.setButtonCache(50);
+
+  shield.mcp.setButtons(BUTTON_UP | BUTTON_SELECT);
+  lcd.clear();
+  uint64_t t = emu::now();
+  lcd.print("y"); // waits for the clear and samples meanwhile
+  CHECK(emu::now() - t < (RGBLCD_CLEAR_US + 1000) * 1000ull);
+  bus.clearLog();
+  CHECK_EQ(lcd.readButtons(), BUTTON_UP | BUTTON_SELECT);
+  CHECK_EQ(bus.logStarts(), 0);
+  CHECK_STR(shield.lcd.row(0), "y               ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
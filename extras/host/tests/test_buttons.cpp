@@ -0,0 +1,116 @@
+/*!
+ * @file test_buttons.cpp
+ *
+ * Button events latched by the interrupt capture of the I/O expander.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDButtons.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(idle_button_poll_is_one_register_read) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDButtons buttons(lcd);
+  buttons.begin();
+
+  bus.clearLog();
+  CHECK_EQ(buttons.poll(), 0);
+  CHECK_EQ(bus.logStarts(), 2);
+  CHECK_EQ(buttons.available(), 0);
+  CHECK_EQ(buttons.read(), 0);
+}
+
+TEST(short_press_between_polls_is_latched) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDButtons buttons(lcd);
+  buttons.begin();
+
+  shield.mcp.setButtons(BUTTON_SELECT);
+  delay(10);
+  shield.mcp.setButtons(0);
+  delay(40);
+  buttons.poll();
+  CHECK_EQ(buttons.available(), 1);
+  CHECK_EQ(buttons.read(), BUTTON_SELECT | BUTTON_PRESS);
+
+  // the release is confirmed by the next poll
+  delay(50);
+  CHECK_EQ(buttons.poll(), 0);
+  CHECK_EQ(buttons.read(), BUTTON_SELECT | BUTTON_RELEASE);
+  CHECK_EQ(buttons.read(), 0);
+
+  // readButtons() polled at the same rate misses it
+  shield.mcp.setButtons(BUTTON_SELECT);
+  delay(10);
+  shield.mcp.setButtons(0);
+  delay(40);
+  CHECK_EQ(lcd.readButtons(), 0);
+}
+
+TEST(bouncing_press_gives_one_press) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDButtons buttons(lcd);
+  buttons.begin();
+
+  // the poll happens while the contact still bounces
+  shield.mcp.setButtons(BUTTON_LEFT);
+  delay(1);
+  shield.mcp.setButtons(0);
+  CHECK_EQ(buttons.poll(), BUTTON_LEFT);
+  delay(1);
+  shield.mcp.setButtons(BUTTON_LEFT);
+  for (int i = 0; i < 5; i++) {
+    delay(50);
+    CHECK_EQ(buttons.poll(), BUTTON_LEFT);
+  }
+  shield.mcp.setButtons(0);
+  delay(1);
+  shield.mcp.setButtons(BUTTON_LEFT);
+  delay(1);
+  shield.mcp.setButtons(0);
+  delay(50);
+  buttons.poll();
+  delay(50);
+  CHECK_EQ(buttons.poll(), 0);
+
+  CHECK_EQ(buttons.read(), BUTTON_LEFT | BUTTON_PRESS);
+  CHECK_EQ(buttons.read(), BUTTON_LEFT | BUTTON_RELEASE);
+  CHECK_EQ(buttons.available(), 0);
+}
+
+TEST(held_button_long_press_and_repeat) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDButtons buttons(lcd);
+  buttons.begin();
+
+  shield.mcp.setButtons(BUTTON_UP);
+  buttons.poll();
+  for (int t = 0; t < 24; t++) {
+    delay(50);
+    buttons.poll();
+  }
+  shield.mcp.setButtons(0);
+  for (int t = 0; t < 2; t++) {
+    delay(50);
+    buttons.poll();
+  }
+
+  // 1200 ms: repeats at 500, 700, 900 and 1100 ms, long press at 1000 ms
+  const uint8_t expect[] = {
+      BUTTON_PRESS,  BUTTON_REPEAT, BUTTON_REPEAT, BUTTON_REPEAT,
+      BUTTON_LONG,   BUTTON_REPEAT, BUTTON_RELEASE};
+  CHECK_EQ(buttons.available(), sizeof(expect));
+  for (size_t i = 0; i < sizeof(expect); i++)
+    CHECK_EQ(buttons.read(), BUTTON_UP | expect[i]);
+}
@@ -0,0 +1,92 @@
+/*!
+ * @file test_cache.cpp
+ *
+ * Register cache of the MCP23017 driver: no read-modify-write round trips.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+static size_t reads(const emu::Bus &bus) {
+  size_t n = 0;
+  for (size_t i = 0; i < bus.log.size(); i++)
+    n += bus.log[i].read;
+  return n;
+}
+
+TEST(set_backlight_needs_no_reads) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.print("abc");
+
+  bus.clearLog();
+  lcd.setBacklight(0x1); // red only: touches both ports
+  CHECK_EQ(reads(bus), 0);
+  CHECK_EQ(bus.logStarts(), 2);
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+
+  bus.clearLog();
+  lcd.setBacklight(0x3); // green on: port A only
+  CHECK_EQ(reads(bus), 0);
+  CHECK_EQ(bus.logStarts(), 1);
+  CHECK_EQ(shield.mcp.backlight(), 0x3);
+
+  bus.clearLog();
+  lcd.setBacklight(0x3);
+  CHECK_EQ(bus.logStarts(), 0);
+
+  // the LCD keeps working and the latch of port B was not clobbered
+  lcd.print("d");
+  CHECK_STR(shield.lcd.row(0), "abcd            ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(pin_writes_keep_mode_and_cache_coherent) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  MCP23017 mcp;
+  mcp.begin();
+  CHECK_EQ(shield.mcp.reg[0x00], 0xff);
+  CHECK_EQ(shield.mcp.reg[0x01], 0xff);
+
+  mcp.pinMode(3, OUTPUT);
+  mcp.burstMode();
+  mcp.pinMode(9, OUTPUT);
+  mcp.pullUp(4, HIGH);
+  bus.clearLog();
+  mcp.digitalWrite(3, HIGH);
+  mcp.digitalWrite(9, HIGH);
+  CHECK_EQ(reads(bus), 0);
+  CHECK_EQ(bus.logStarts(), 2);
+  mcp.normalMode();
+  mcp.digitalWrite(3, LOW);
+
+  CHECK(!shield.mcp.bank());
+  CHECK_EQ(shield.mcp.reg[0x00], 0xf7); // IODIRA
+  CHECK_EQ(shield.mcp.reg[0x01], 0xfd); // IODIRB
+  CHECK_EQ(shield.mcp.reg[0x0C], 0x10); // GPPUA
+  CHECK_EQ(shield.mcp.reg[0x14], 0x00); // OLATA
+  CHECK_EQ(shield.mcp.reg[0x15], 0x02); // OLATB
+}
+
+TEST(resync_restores_a_reset_chip) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setBacklight(0x5);
+  uint8_t before[0x16];
+  memcpy(before, shield.mcp.reg, sizeof(before));
+
+  shield.mcp.powerOn();
+  CHECK(!shield.mcp.bank());
+  lcd.resync();
+  CHECK(memcmp(before, shield.mcp.reg, sizeof(before)) == 0);
+
+  lcd.print("ok");
+  CHECK_STR(shield.lcd.row(0), "ok              ");
+  CHECK_EQ(shield.mcp.backlight(), 0x5);
+}
@@ -0,0 +1,45 @@
+/*!
+ * @file test_calibrate.cpp
+ *
+ * I2C clock calibration: the chosen clock keeps the margin below the limit
+ * of the wiring, and the display works afterwards.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(calibrate_up_to_the_maximum) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  uint32_t clock = lcd.calibrateClock(800000);
+  CHECK_EQ(clock, 800000 * (100 - RGBLCD_CALIBRATE_MARGIN) / 100);
+  CHECK_EQ(bus.getClock(), clock);
+  lcd.print("fast");
+  CHECK_STR(shield.lcd.row(0), "fast            ");
+}
+
+TEST(calibrate_stops_at_the_limit_and_recovers) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setBacklight(0x1);
+
+  bus.setLimit(450000);
+  uint32_t clock = lcd.calibrateClock();
+  CHECK_EQ(clock, 400000 * (100 - RGBLCD_CALIBRATE_MARGIN) / 100);
+  CHECK_EQ(bus.getClock(), clock);
+
+  // the garbled step did not leave the expander or the LCD confused
+  lcd.setCursor(2, 1);
+  lcd.print("ok");
+  CHECK_STR(shield.lcd.row(0), "                ");
+  CHECK_STR(shield.lcd.row(1), "  ok            ");
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+  CHECK(shield.mcp.bank());
+}
@@ -0,0 +1,151 @@
+/*!
+ * @file test_cursor.cpp
+ *
+ * Cursor tracking and line wrapping.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrst"
+                               "uvwxyz0123456789!#$%&()*+-/<=>?@[]^_{|}~";
+
+static bool anyRead(const emu::Bus &bus) {
+  for (size_t i = 0; i < bus.log.size(); i++)
+    if (bus.log[i].read)
+      return true;
+  return false;
+}
+
+TEST(cursor_redundant_set_is_free) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  lcd.setCursor(3, 1);
+  lcd.print("ab");
+  bus.clearLog();
+  lcd.setCursor(5, 1);
+  CHECK_EQ(bus.logStarts(), 0);
+  lcd.print("c");
+  CHECK_STR(shield.lcd.row(1), "   abc          ");
+
+  // home after clear()
+  lcd.clear();
+  bus.clearLog();
+  lcd.setCursor(0, 0);
+  CHECK_EQ(bus.logStarts(), 0);
+
+  // rows beyond the last one go to the last one
+  lcd.setCursor(2, 2);
+  lcd.print("x");
+  CHECK_STR(shield.lcd.row(1), "  x             ");
+}
+
+TEST(cursor_createchar_needs_no_read) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  uint8_t glyph[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  lcd.setCursor(4, 1);
+  bus.clearLog();
+  lcd.createChar(2, glyph);
+  CHECK(!anyRead(bus));
+  CHECK_EQ(bus.logStarts(), 2); // chunks of the Wire buffer
+  lcd.print("y");
+  CHECK_STR(shield.lcd.row(1), "    y           ");
+  CHECK_EQ(shield.lcd.cgram[2 * 8 + 7], 8);
+}
+
+TEST(cursor_wraps_16x2) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.lineWrap();
+
+  lcd.setCursor(10, 0);
+  lcd.print("0123456789");
+  CHECK_STR(shield.lcd.row(0), "          012345");
+  CHECK_STR(shield.lcd.row(1), "6789            ");
+  lcd.setCursor(14, 1);
+  lcd.print("xyz");
+  CHECK_STR(shield.lcd.row(1), "6789          xy");
+  CHECK_STR(shield.lcd.row(0), "z         012345");
+
+  // a row written up to its end leaves the cursor in the next one
+  lcd.setCursor(0, 0);
+  lcd.print("0123456789abcdef");
+  lcd.print("!");
+  CHECK_STR(shield.lcd.row(1), "!789          xy");
+
+  lcd.noLineWrap();
+  lcd.setCursor(14, 0);
+  lcd.print("ABCD");
+  CHECK_STR(shield.lcd.row(0), "0123456789abcdAB");
+  CHECK_STR(shield.lcd.row(1), "!789          xy");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(cursor_wraps_20x4_in_row_order) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(20, 4);
+  lcd.lineWrap();
+
+  lcd.write((const uint8_t *)alphabet, 80);
+  std::string text(alphabet, 80);
+  for (uint8_t r = 0; r < 4; r++)
+    CHECK_STR(shield.lcd.row(r, 20), text.substr(20 * r, 20));
+  // and around to the top
+  lcd.print("+");
+  CHECK_EQ(shield.lcd.ddram[0x00], '+');
+}
+
+TEST(cursor_wraps_40x2_without_commands) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(40, 2);
+  lcd.lineWrap();
+
+  unsigned before = shield.lcd.instructions;
+  lcd.write((const uint8_t *)alphabet, 80);
+  // the DDRAM continues with the next row by itself
+  CHECK_EQ(shield.lcd.instructions, before);
+  std::string text(alphabet, 80);
+  CHECK_STR(shield.lcd.row(0, 40), text.substr(0, 40));
+  CHECK_STR(shield.lcd.row(1, 40), text.substr(40, 40));
+}
+
+TEST(cursor_wraps_on_page_1) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.lineWrap();
+
+  lcd.drawPage(1);
+  lcd.write((const uint8_t *)alphabet, 32);
+  lcd.showPage(1);
+  std::string text(alphabet, 32);
+  CHECK_STR(shield.lcd.row(0), text.substr(0, 16));
+  CHECK_STR(shield.lcd.row(1), text.substr(16, 16));
+}
+
+TEST(cursor_wraps_in_shadow) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  lcd.lineWrap();
+  lcd.shadow(fb);
+
+  lcd.setCursor(12, 1);
+  lcd.print("wrapped");
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(1), "            wrap");
+  CHECK_STR(shield.lcd.row(0), "ped             ");
+}
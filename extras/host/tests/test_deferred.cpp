@@ -0,0 +1,53 @@
+/*!
+ * @file test_deferred.cpp
+ *
+ * Deferred completion of clear() and home().
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(deferred_clear_returns_at_once) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.print("xyz");
+  lcd.setDeferred(true);
+
+  uint64_t t = emu::now();
+  lcd.clear();
+  CHECK(emu::now() - t < 1000000ull);
+  CHECK(!lcd.isReady());
+
+  // Buttons and backlight do not need the LCD.
+  shield.mcp.setButtons(BUTTON_LEFT);
+  CHECK_EQ(lcd.readButtons(), BUTTON_LEFT);
+  lcd.setBacklight(0x2);
+  CHECK_EQ(shield.mcp.backlight(), 0x2);
+
+  lcd.print("ab");
+  CHECK(lcd.isReady());
+  CHECK_STR(shield.lcd.row(0), "ab              ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(deferred_home_completes_in_background) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setDeferred(true);
+  lcd.print("12345");
+  lcd.home();
+  CHECK(!lcd.isReady());
+  delay(3);
+  CHECK(lcd.isReady());
+
+  // no wait at all now
+  uint64_t t = emu::now();
+  lcd.print("x");
+  CHECK(emu::now() - t < 1000000ull);
+  CHECK_STR(shield.lcd.row(0), "x2345           ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
@@ -0,0 +1,88 @@
+/*!
+ * @file test_field.cpp
+ *
+ * Fixed-width number fields.
+ */
+
+#include "test.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+// Reference formatting with printf.
+static std::string reference(int32_t value, uint8_t width, uint8_t decimals,
+                             char pad) {
+  char buf[40];
+  unsigned long v = (value < 0) ? -(uint32_t)value : value;
+  unsigned long scale = 1;
+  for (uint8_t i = 0; i < decimals; i++)
+    scale *= 10;
+  if (decimals)
+    snprintf(buf, sizeof(buf), "%s%lu.%0*lu", value < 0 ? "-" : "", v / scale,
+             (int)decimals, v % scale);
+  else
+    snprintf(buf, sizeof(buf), "%s%lu", value < 0 ? "-" : "", v);
+  std::string s(buf);
+  if (width && s.size() > width)
+    return std::string(width, '#');
+  if (s.size() < width) {
+    size_t fill = width - s.size();
+    if (pad == '0')
+      s.insert(value < 0 ? 1 : 0, fill, '0');
+    else
+      s.insert((size_t)0, fill, pad);
+  }
+  return s;
+}
+
+static std::string shown(emu::Shield &shield, size_t n) {
+  return shield.lcd.row(0, 40).substr(0, n);
+}
+
+TEST(field_matches_printf) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(40, 2);
+
+  const int32_t values[] = {0,     1,     -1,        9,          10,
+                            99,    100,   -205,      12345,      -99999,
+                            65535, 65536, 999999999, 1000000000, INT32_MAX,
+                            INT32_MIN, -7, 42};
+  const uint8_t widths[] = {0, 1, 4, 6, 12};
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    for (size_t w = 0; w < sizeof(widths); w++)
+      for (uint8_t decimals = 0; decimals <= 3; decimals++)
+        for (int z = 0; z < 2; z++) {
+          char pad = z ? '0' : ' ';
+          std::string want = reference(values[i], widths[w], decimals, pad);
+          lcd.setCursor(0, 0);
+          size_t n = lcd.printField(values[i], widths[w], decimals, pad);
+          CHECK_EQ(n, want.size());
+          CHECK_STR(shown(shield, want.size()), want);
+        }
+}
+
+TEST(field_in_one_burst) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  lcd.setCursor(0, 0);
+  bus.clearLog();
+  CHECK_EQ(lcd.printField(-215, 6, 1), 6);
+  CHECK_STR(shield.lcd.row(0), " -21.5          ");
+  // pointer, RS and 6 characters of 4 bytes: one transaction, as print()
+  CHECK_EQ(bus.logStarts(), 1);
+  CHECK_EQ(bus.logBytes(), 2u + 1 + 6 * 4);
+
+  uint8_t shadow[LCD_SHADOW_SIZE(16, 2)];
+  lcd.shadow(shadow);
+  lcd.setCursor(10, 1);
+  lcd.printField(7, 5, 0, '0');
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(1), "          00007 ");
+}
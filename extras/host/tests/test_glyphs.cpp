@@ -0,0 +1,133 @@
+/*!
+ * @file test_glyphs.cpp
+ *
+ * Single transaction CGRAM uploads and the glyph manager.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDGlyphs.h>
+#include <RGBLCDShield_Fast.h>
+#include <Wire.h>
+
+static const uint8_t glyphs[12][8] PROGMEM = {
+    {0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}, {10}, {11}};
+
+// Number of LCD write transactions, checking that all but the last one
+// are only split by the Wire buffer size.
+static size_t bursts(const emu::Bus &bus) {
+  size_t n = 0, last = 0;
+  for (size_t i = 0; i < bus.log.size(); i++) {
+    size_t len = bus.log[i].data.size();
+    if (bus.log[i].read || len <= 3)
+      continue; // busy flag and address counter reads
+    if (n > 0)
+      CHECK(last > BUFFER_LENGTH - 6);
+    last = len;
+    n++;
+  }
+  return n;
+}
+
+TEST(create_char_is_one_burst_and_keeps_cursor) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setCursor(3, 1);
+  lcd.print("ab");
+
+  uint8_t glyph[8] = {0x1f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1f};
+  bus.clearLog();
+  lcd.createChar(5, glyph);
+  // 43 bytes: command, 8 rows and DDRAM address, split by the Wire buffer
+  CHECK_EQ(bursts(bus), 2);
+  CHECK(memcmp(shield.lcd.cgram + 40, glyph, 8) == 0);
+
+  lcd.createCharPgm(6, glyphs[9]);
+  CHECK_EQ(shield.lcd.cgram[48], 9);
+
+  lcd.write(5);
+  CHECK_EQ(shield.lcd.ddram[0x45], 5);
+  CHECK_STR(shield.lcd.row(1), "   ab\x05          ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(glyph_manager_uploads_only_missing_glyphs) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDGlyphs manager(lcd, glyphs, 12);
+
+  uint8_t code = manager.get(10);
+  CHECK_EQ(shield.lcd.cgram[code * 8], 10);
+  bus.clearLog();
+  CHECK_EQ(manager.get(10), code);
+  CHECK_EQ(bus.logStarts(), 0);
+
+  manager.write(10);
+  manager.write(11);
+  CHECK_EQ(shield.lcd.ddram[0], code);
+  CHECK_EQ(shield.lcd.cgram[shield.lcd.ddram[1] * 8], 11);
+  CHECK_EQ(manager.get(200), ' ');
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(glyph_manager_evicts_least_recently_used) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDGlyphs manager(lcd, glyphs, 12);
+
+  for (uint8_t id = 0; id < 8; id++)
+    manager.get(id);
+  manager.get(0); // 1 is the oldest now
+  uint8_t code = manager.get(8);
+  CHECK(!manager.resident(1));
+  CHECK(manager.resident(0));
+  CHECK_EQ(shield.lcd.cgram[code * 8], 8);
+  for (uint8_t id = 2; id < 9; id++)
+    CHECK(manager.resident(id));
+}
+
+TEST(glyph_manager_loads_a_screen_in_one_burst) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDGlyphs manager(lcd, glyphs, 12);
+  lcd.setCursor(7, 0);
+
+  const uint8_t first[] = {0, 1, 2, 3, 4, 5, 6, 7};
+  bus.clearLog();
+  manager.load(first, 8);
+  size_t all = bursts(bus);
+
+  // 4 stay, 4 are replaced without touching the ones of the new screen
+  const uint8_t second[] = {8, 2, 9, 4, 10, 6, 11, 0};
+  bus.clearLog();
+  manager.load(second, 8);
+  CHECK(bursts(bus) <= all / 2 + 1);
+  for (uint8_t i = 0; i < 8; i++) {
+    CHECK(manager.resident(second[i]));
+    CHECK_EQ(shield.lcd.cgram[manager.get(second[i]) * 8], second[i]);
+  }
+
+  bus.clearLog();
+  manager.load(second, 8);
+  CHECK_EQ(bus.logStarts(), 0);
+
+  // only the first 8 of more ids, which all stay resident
+  const uint8_t third[] = {1, 3, 5, 7, 9, 11, 0, 2, 4, 6};
+  manager.load(third, 10);
+  for (uint8_t i = 0; i < 8; i++)
+    CHECK(manager.resident(third[i]));
+  CHECK(!manager.resident(4) && !manager.resident(6));
+  CHECK_EQ(manager.get(12), ' ');
+
+  lcd.print("x");
+  CHECK_STR(shield.lcd.row(0), "       x        ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
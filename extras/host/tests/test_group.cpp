@@ -0,0 +1,151 @@
+/*!
+ * @file test_group.cpp
+ *
+ * Several shields on one bus, individually and as a group.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDGroup.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(shields_at_different_addresses) {
+  emu::Shield s0(0x20), s1(0x21);
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd0, lcd1(1);
+  lcd0.begin(16, 2);
+  lcd1.begin(16, 2);
+  lcd0.print("zero");
+  lcd1.print("one");
+  lcd1.setBacklight(0x4);
+
+  s1.mcp.setButtons(BUTTON_UP);
+  bus.clearLog();
+  CHECK_EQ(lcd0.readButtons(), 0);
+  CHECK_EQ(lcd1.readButtons(), BUTTON_UP);
+  for (size_t i = 0; i < bus.log.size(); i++)
+    CHECK(bus.log[i].addr == 0x20 + (i >= bus.log.size() / 2));
+
+  CHECK_STR(s0.lcd.row(0), "zero            ");
+  CHECK_STR(s1.lcd.row(0), "one             ");
+  CHECK_EQ(s0.mcp.backlight(), 0x7);
+  CHECK_EQ(s1.mcp.backlight(), 0x4);
+  CHECK_EQ(s0.lcd.violations + s1.lcd.violations, 0);
+}
+
+TEST(group_begin_shares_the_power_on_delays) {
+  emu::Shield s0(0x20), s1(0x21), s2(0x22), s3(0x23);
+  RGBLCDShield_Fast lcd0(0), lcd1(1), lcd2(2), lcd3(3);
+  RGBLCDGroup group;
+  CHECK(group.add(lcd0) && group.add(lcd1) && group.add(lcd2) &&
+        group.add(lcd3));
+  CHECK_EQ(group.size(), 4);
+
+  uint64_t t = emu::now();
+  lcd0.begin(16, 2);
+  uint64_t single = emu::now() - t;
+
+  s0.lcd.powerOn();
+  s0.mcp.powerOn();
+  t = emu::now();
+  group.begin(16, 2);
+  group.print("all");
+  // one power-on wait and reset sequence for all, plus the extra traffic
+  CHECK(emu::now() - t < 2 * single);
+
+  emu::Shield *s[] = {&s0, &s1, &s2, &s3};
+  for (int i = 0; i < 4; i++) {
+    CHECK_STR(s[i]->lcd.row(0), "all             ");
+    CHECK_EQ(s[i]->lcd.violations, 0);
+  }
+}
+
+TEST(group_clear_overlaps_the_waits) {
+  emu::Shield s0(0x20), s1(0x21), s2(0x22), s3(0x23);
+  RGBLCDShield_Fast lcd0(0), lcd1(1), lcd2(2), lcd3(3);
+  RGBLCDGroup group;
+  group.add(lcd0);
+  group.add(lcd1);
+  group.add(lcd2);
+  group.add(lcd3);
+  group.begin(16, 2);
+  group.print("old text");
+
+  uint64_t t = emu::now();
+  for (uint8_t i = 0; i < group.size(); i++) {
+    group[i].clear();
+    group[i].setCursor(0, 1);
+    group[i].print("new");
+  }
+  uint64_t serial = emu::now() - t;
+
+  t = emu::now();
+  group.clear();
+  group.setCursor(0, 1);
+  group.print("new");
+  // the clear time of three displays is spent transmitting to the others
+  CHECK(emu::now() - t + 3ull * RGBLCD_CLEAR_US * 1000 / 2 < serial);
+
+  emu::Shield *s[] = {&s0, &s1, &s2, &s3};
+  for (int i = 0; i < 4; i++) {
+    CHECK_STR(s[i]->lcd.row(0), "                ");
+    CHECK_STR(s[i]->lcd.row(1), "new             ");
+    CHECK_EQ(s[i]->lcd.violations, 0);
+  }
+  // the group leaves the blocking behaviour of the displays alone
+  lcd2.clear();
+  CHECK(lcd2.isReady());
+}
+
+TEST(group_serves_busy_displays_by_readiness) {
+  emu::Shield s0(0x20), s1(0x21), s2(0x22);
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd0(0), lcd1(1), lcd2(2);
+  RGBLCDGroup group;
+  group.add(lcd0);
+  group.add(lcd1);
+  group.add(lcd2);
+  group.begin(16, 2);
+  lcd0.setDeferred(true);
+  lcd1.setDeferred(true);
+  lcd2.setDeferred(true);
+
+  // all still busy, done in the order 1, 2, 0
+  lcd1.clear();
+  lcd2.clear();
+  lcd0.clear();
+  bus.clearLog();
+  group.setCursor(0, 1);
+  uint8_t served[3], n = 0;
+  for (size_t i = 0; i < bus.log.size() && n < 3; i++)
+    if (n == 0 || bus.log[i].addr != served[n - 1])
+      served[n++] = bus.log[i].addr;
+  CHECK_EQ(n, 3);
+  CHECK_EQ(served[0], 0x21);
+  CHECK_EQ(served[1], 0x22);
+  CHECK_EQ(served[2], 0x20);
+}
+
+TEST(group_write_each) {
+  emu::Shield s0(0x20), s1(0x21);
+  RGBLCDShield_Fast lcd0(0), lcd1(1);
+  RGBLCDGroup group;
+  group.add(lcd0);
+  group.add(lcd1);
+  group.begin(16, 2);
+  group.setBacklight(0x2);
+
+  const uint8_t *text[] = {(const uint8_t *)"left ",
+                           (const uint8_t *)"right"};
+  group.writeEach(text, 5);
+  text[0] = 0;
+  text[1] = (const uint8_t *)"!";
+  group.writeEach(text, 1);
+
+  CHECK_STR(s0.lcd.row(0), "left            ");
+  CHECK_STR(s1.lcd.row(0), "right!          ");
+  CHECK_EQ(s0.mcp.backlight(), 0x2);
+  CHECK_EQ(s1.mcp.backlight(), 0x2);
+  CHECK_EQ(&group[1], &lcd1);
+}
@@ -0,0 +1,100 @@
+/*!
+ * @file test_pages.cpp
+ *
+ * Page flipping with the display shift.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDBars.h>
+#include <RGBLCDShield_Fast.h>
+
+TEST(pages_draw_hidden_and_flip) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  CHECK_EQ(lcd.pages(), 2);
+
+  lcd.print("page zero");
+  lcd.drawPage(1);
+  lcd.print("page one, top");
+  lcd.setCursor(2, 1);
+  lcd.print("bottom");
+  // nothing of it visible yet
+  CHECK_STR(shield.lcd.row(0), "page zero       ");
+  CHECK_STR(shield.lcd.row(1), "                ");
+
+  bus.clearLog();
+  lcd.showPage(1);
+  CHECK_STR(shield.lcd.row(0), "page one, top   ");
+  CHECK_STR(shield.lcd.row(1), "  bottom        ");
+  // 16 commands of 4 bytes, one RS change, in chunks of the Wire buffer
+  CHECK_EQ(bus.logStarts(), 3);
+  CHECK_EQ(bus.logBytes(), 3 * 2u + 1 + 16 * 4);
+
+  bus.clearLog();
+  lcd.showPage(0);
+  CHECK_STR(shield.lcd.row(0), "page zero       ");
+  CHECK_EQ(shield.lcd.shift, 0);
+  CHECK_EQ(shield.lcd.violations, 0);
+
+  // drawing goes on where it was on the hidden page
+  lcd.print("!");
+  CHECK_STR(shield.lcd.row(1), "                ");
+  CHECK_EQ(shield.lcd.ddram[0x40 + 16 + 8], '!');
+
+  // already shown: free
+  bus.clearLog();
+  lcd.showPage(0);
+  CHECK_EQ(bus.logStarts(), 0);
+}
+
+TEST(pages_flip_swaps_buffers) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(20, 2);
+
+  lcd.drawPage(1);
+  for (int frame = 0; frame < 5; frame++) {
+    lcd.setCursor(0, 0);
+    lcd.print("frame ");
+    lcd.print(frame);
+    lcd.flip();
+    CHECK_EQ(shield.lcd.shift, (frame % 2 == 0) ? 20 : 0);
+    char want[21];
+    snprintf(want, sizeof(want), "frame %-14d", frame);
+    CHECK_STR(shield.lcd.row(0, 20), want);
+  }
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(pages_take_the_bars) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDHBar bar(lcd, 2, 1, 10);
+  bar.begin();
+
+  lcd.drawPage(1);
+  bar.set(23);
+  CHECK_STR(shield.lcd.row(1), "                ");
+  for (int i = 0; i < 4; i++)
+    CHECK_EQ(shield.lcd.ddram[0x40 + 16 + 2 + i], 0xff);
+  lcd.showPage(1);
+  CHECK_EQ(shield.lcd.row(1)[5], (char)0xff);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(pages_single_on_large_displays) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(20, 4);
+  CHECK_EQ(lcd.pages(), 1);
+  lcd.drawPage(1);
+  lcd.print("x");
+  lcd.showPage(1);
+  CHECK_EQ(shield.lcd.shift, 0);
+  CHECK_EQ(shield.lcd.ddram[0], 'x');
+}
@@ -0,0 +1,103 @@
+/*!
+ * @file test_shadow.cpp
+ *
+ * Shadow framebuffer and flush().
+ */
+
+#include "test.h"
+
+#include <RGBLCDShield_Fast.h>
+
+TEST(shadow_first_flush_sends_everything) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  lcd.shadow(fb);
+  lcd.print("Temp");
+  lcd.setCursor(0, 1);
+  lcd.print("Rate");
+  CHECK_STR(shield.lcd.row(0), "                ");
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(0), "Temp            ");
+  CHECK_STR(shield.lcd.row(1), "Rate            ");
+  CHECK_EQ(lcd.flushStats().cells, 32);
+  CHECK_EQ(lcd.flushStats().runs, 1); // the cursor is home after clear()
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(shadow_sends_only_changed_cells) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  lcd.shadow(fb);
+  lcd.print("T: 21.5 C");
+  lcd.flush();
+
+  emu::Bus::instance().clearLog();
+  lcd.setCursor(0, 0);
+  lcd.print("T: 21.5 C");
+  lcd.flush();
+  CHECK_EQ(lcd.flushStats().cells, 0);
+  CHECK_EQ(lcd.flushStats().bytes, 0);
+  CHECK_EQ(emu::Bus::instance().logStarts(), 0);
+
+  // Two digits with one unchanged cell in between: a single run.
+  lcd.setCursor(0, 0);
+  lcd.print("T: 23.7 C");
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(0), "T: 23.7 C       ");
+  CHECK_EQ(lcd.flushStats().cells, 2);
+  CHECK_EQ(lcd.flushStats().runs, 1);
+  CHECK_EQ(lcd.flushStats().bytes, emu::Bus::instance().logBytes());
+  CHECK_EQ(emu::Bus::instance().logStarts(), 1);
+
+  // Far apart: two address commands, still one transaction.
+  emu::Bus::instance().clearLog();
+  lcd.setCursor(0, 0);
+  lcd.write('X');
+  lcd.setCursor(8, 1);
+  lcd.write('Y');
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(0), "X: 23.7 C       ");
+  CHECK_STR(shield.lcd.row(1), "        Y       ");
+  CHECK_EQ(lcd.flushStats().runs, 2);
+  CHECK_EQ(emu::Bus::instance().logStarts(), 1);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(shadow_clear_and_clipping) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  lcd.shadow(fb);
+  lcd.print("0123456789abcdefOVERFLOW");
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(0), "0123456789abcdef");
+  CHECK_STR(shield.lcd.row(1), "                ");
+  lcd.clear();
+  lcd.print("hi");
+  lcd.flush();
+  CHECK_STR(shield.lcd.row(0), "hi              ");
+  CHECK_EQ(lcd.flushStats().cells, 16);
+}
+
+TEST(shadow_20x4_runs_on_into_row_2) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(20, 4)];
+  lcd.begin(20, 4);
+  lcd.shadow(fb);
+  lcd.flush();
+  lcd.setCursor(19, 0);
+  lcd.write('A');
+  lcd.setCursor(0, 2);
+  lcd.write('B');
+  lcd.flush();
+  CHECK_EQ(lcd.flushStats().cells, 2);
+  CHECK_EQ(lcd.flushStats().runs, 1);
+  CHECK_EQ(shield.lcd.row(0, 20)[19], 'A');
+  CHECK_EQ(shield.lcd.row(2, 20)[0], 'B');
+}
@@ -0,0 +1,75 @@
+/*!
+ * @file test_stats.cpp
+ *
+ * Bus statistics: the counters agree with the traffic the emulator sees.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+static RGBLCDBusStats stats(uint8_t op) {
+  RGBLCDBusStats s;
+  RGBLCDShield_Fast::busStats(op, s, emu::Bus::instance().getClock());
+  return s;
+}
+
+TEST(stats_match_the_bus) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  RGBLCDShield_Fast::resetBusStats();
+  bus.clearLog();
+  uint64_t t0 = emu::now();
+  lcd.print("AB");
+  RGBLCDBusStats s = stats(LCD_OP_WRITE);
+  CHECK_EQ(s.calls, 1);
+  CHECK_EQ(s.transactions, 1);
+  CHECK_EQ(s.starts, bus.logStarts());
+  CHECK_EQ(s.written + s.starts, bus.logBytes());
+  CHECK_EQ(s.read, 0);
+  CHECK_EQ(s.us, (emu::now() - t0) / 1000);
+  CHECK_EQ(stats(LCD_OP_SEND).calls, 0);
+
+  bus.clearLog();
+  lcd.readButtons();
+  s = stats(LCD_OP_BUTTONS);
+  CHECK_EQ(s.calls, 1);
+  CHECK_EQ(s.starts, 2);
+  CHECK_EQ(s.transactions, 2);
+  CHECK_EQ(s.written, 1);
+  CHECK_EQ(s.read, 1);
+}
+
+TEST(stats_count_nested_traffic_for_the_caller) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+
+  RGBLCDShield_Fast::resetBusStats();
+  lcd.begin(16, 2);
+  RGBLCDBusStats s = stats(LCD_OP_BEGIN);
+  CHECK_EQ(s.calls, 1);
+  CHECK(s.polls >= 1); // the final clear()
+  CHECK_EQ(stats(LCD_OP_SEND).calls, 0);
+  CHECK_EQ(stats(LCD_OP_OTHER).starts, 0);
+
+  lcd.clear();
+  s = stats(LCD_OP_SEND);
+  CHECK_EQ(s.calls, 1);
+  CHECK(s.polls >= 1);
+  CHECK(s.read >= s.polls);
+
+  uint8_t glyph[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  lcd.createChar(3, glyph);
+  lcd.setBacklight(0x1); // red only: both ports
+  CHECK_EQ(stats(LCD_OP_CREATECHAR).calls, 1);
+  CHECK_EQ(stats(LCD_OP_BACKLIGHT).calls, 1);
+  CHECK_EQ(stats(LCD_OP_BACKLIGHT).transactions, 2);
+
+  RGBLCDShield_Fast::resetBusStats();
+  CHECK_EQ(stats(LCD_OP_BEGIN).calls, 0);
+  CHECK_EQ(stats(LCD_OP_SEND).bits, 0);
+}
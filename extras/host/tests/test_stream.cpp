@@ -0,0 +1,100 @@
+/*!
+ * @file test_stream.cpp
+ *
+ * Exact I2C byte stream of single API calls.  A change here changes the
+ * bus time of every sketch, so it should be deliberate.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+
+// Formats the log as "W 19 84 a4 | R 1", one entry per transaction.
+static std::string stream(const emu::Bus &bus) {
+  std::string s;
+  char hex[4];
+  for (size_t i = 0; i < bus.log.size(); i++) {
+    const emu::Transaction &t = bus.log[i];
+    if (i)
+      s += " | ";
+    if (t.read) {
+      snprintf(hex, sizeof(hex), "%u", (unsigned)t.data.size());
+      s += std::string("R ") + hex;
+      continue;
+    }
+    s += "W";
+    for (size_t j = 0; j < t.data.size(); j++) {
+      snprintf(hex, sizeof(hex), " %02x", t.data[j]);
+      s += hex;
+    }
+  }
+  return s;
+}
+
+TEST(stream_of_characters) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  // RS goes high first, then E pulses for each nibble: D4..D7 are GPB4..1
+  bus.clearLog();
+  lcd.write('A');
+  CHECK_STR(stream(bus), "W 19 84 a4 84 b0 90");
+  bus.clearLog();
+  lcd.print("BC");
+  CHECK_STR(stream(bus), "W 19 a4 84 a8 88 a4 84 b8 98");
+}
+
+TEST(stream_of_flash_strings) {
+  static const uint8_t data[] PROGMEM = {'B', 'C'};
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.write('A');
+
+  // the same burst as print("BC"), not one transaction per character
+  bus.clearLog();
+  lcd.print(F("BC"));
+  CHECK_STR(stream(bus), "W 19 a4 84 a8 88 a4 84 b8 98");
+  bus.clearLog();
+  CHECK_EQ(lcd.writePgm(data, sizeof(data)), 2);
+  CHECK_STR(stream(bus), "W 19 a4 84 a8 88 a4 84 b8 98");
+  CHECK_STR(shield.lcd.row(0), "ABCBC           ");
+
+  bus.clearLog();
+  CHECK_EQ(lcd.print(F("0123456789abcdef")), 16);
+  CHECK_EQ(bus.logStarts(), 3); // chunks of the Wire buffer
+  CHECK_EQ(lcd.println(F("x")), 3);
+}
+
+TEST(stream_of_commands) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.write('x');
+
+  bus.clearLog();
+  lcd.setCursor(0, 1);
+  CHECK_STR(stream(bus), "W 19 06 26 06 20 00");
+  bus.clearLog();
+  lcd.noDisplay();
+  CHECK_STR(stream(bus), "W 19 20 00 22 02");
+}
+
+TEST(stream_of_backlight_and_buttons) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  bus.clearLog();
+  lcd.setBacklight(0x1); // red: green off on port A, blue off on port B
+  CHECK_STR(stream(bus), "W 09 80 | W 19 01");
+  bus.clearLog();
+  lcd.readButtons();
+  CHECK_STR(stream(bus), "W 09 | R 1");
+}
@@ -0,0 +1,202 @@
+/*!
+ * @file test_terminal.cpp
+ *
+ * VT100 subset and flow control of the terminal.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+#include <RGBLCDTerminal.h>
+
+// Serial port stand-in: input queued by the test, output recorded.  Input
+// sent with arrive() comes in one byte per gap of simulated time, the
+// sender honours XON/XOFF.
+class FakeSerial : public Stream {
+public:
+  std::string in, out, line;
+  size_t pos, peak;
+  uint64_t next, gap;
+  bool stopped;
+  FakeSerial() : pos(0), peak(0), next(0), gap(0), stopped(false) {}
+  void feed(const char *s) { in += s; }
+  void arrive(const char *s, uint64_t ns) {
+    line += s;
+    next = emu::now() + ns;
+    gap = ns;
+  }
+  int available() {
+    while (!stopped && !line.empty() && emu::now() >= next) {
+      in += line[0];
+      line.erase(0, 1);
+      next += gap;
+    }
+    if (in.size() - pos > peak)
+      peak = in.size() - pos;
+    return (int)(in.size() - pos);
+  }
+  int read() { return (pos < in.size()) ? (uint8_t)in[pos++] : -1; }
+  int peek() { return (pos < in.size()) ? (uint8_t)in[pos] : -1; }
+  size_t write(uint8_t c) {
+    available(); // what came in so far
+    out += (char)c;
+    if (c == RGBLCD_XOFF)
+      stopped = true;
+    if (c == RGBLCD_XON && stopped) {
+      stopped = false;
+      next = emu::now() + gap;
+    }
+    return 1;
+  }
+};
+
+TEST(terminal_text_and_scrolling) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  RGBLCDTerminal term(lcd, fb);
+  term.begin();
+
+  term.print("Hello\nworld");
+  CHECK_STR(shield.lcd.row(0), "Hello           ");
+  CHECK_STR(shield.lcd.row(1), "world           ");
+  term.print("\r\nthird line");
+  CHECK_STR(shield.lcd.row(0), "world           ");
+  CHECK_STR(shield.lcd.row(1), "third line      ");
+
+  // a full row does not scroll before the next character
+  term.print("\r0123456789abcdef");
+  CHECK_STR(shield.lcd.row(1), "0123456789abcdef");
+  term.print("!");
+  CHECK_STR(shield.lcd.row(0), "0123456789abcdef");
+  CHECK_STR(shield.lcd.row(1), "!               ");
+
+  term.print("\b\bx\ty");
+  CHECK_STR(shield.lcd.row(1), "x       y       ");
+  term.print("\f");
+  CHECK_STR(shield.lcd.row(0), "                ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(terminal_escape_sequences) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(20, 4)];
+  lcd.begin(20, 4);
+  RGBLCDTerminal term(lcd, fb);
+  term.begin();
+
+  term.print("\x1b[2;5HTemp\x1b[4;1HRate\x1b[H*");
+  CHECK_STR(shield.lcd.row(0, 20), "*                   ");
+  CHECK_STR(shield.lcd.row(1, 20), "    Temp            ");
+  CHECK_STR(shield.lcd.row(3, 20), "Rate                ");
+
+  term.print("\x1b[2;1H\x1b[3CX\x1b[BY\x1b[2DZ\x1b[AW");
+  CHECK_STR(shield.lcd.row(1, 20), "   XWemp            ");
+  CHECK_STR(shield.lcd.row(2, 20), "   ZY               ");
+  // large counts stop at the margin
+  term.print("\x1b[s\x1b[256C\x1b[259D\x1b[999B+\x1b[u");
+  CHECK_STR(shield.lcd.row(3, 20), "+ate                ");
+
+  term.print("\x1b[2;6H\x1b[K");
+  CHECK_STR(shield.lcd.row(1, 20), "   XW               ");
+  term.print("\x1b[1K");
+  CHECK_STR(shield.lcd.row(1, 20), "                    ");
+  term.print("\x1b[s\x1b[4;3H\x1b[2K\x1b[u!");
+  CHECK_STR(shield.lcd.row(3, 20), "                    ");
+  CHECK_STR(shield.lcd.row(1, 20), "     !              ");
+  term.print("\x1b[J");
+  CHECK_STR(shield.lcd.row(1, 20), "     !              ");
+  CHECK_STR(shield.lcd.row(2, 20), "                    ");
+  term.print("\x1b[2J");
+  CHECK_STR(shield.lcd.row(0, 20), "                    ");
+
+  // without new line mode, LF keeps the column
+  term.print("\x1b[20l\x1b[Hab\ncd");
+  CHECK_STR(shield.lcd.row(1, 20), "  cd                ");
+  term.print("\x1b[?25h");
+  CHECK(shield.lcd.cursorOn);
+  term.print("\x1b[?25l");
+  CHECK(!shield.lcd.cursorOn);
+}
+
+TEST(terminal_sgr_sets_backlight) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  RGBLCDTerminal term(lcd, fb);
+  term.begin();
+
+  term.print("\x1b[31mred");
+  CHECK_EQ(shield.mcp.backlight(), 0x1);
+  term.print("\x1b[1;46m");
+  CHECK_EQ(shield.mcp.backlight(), 0x6);
+  term.print("\x1b[m");
+  CHECK_EQ(shield.mcp.backlight(), 0x7);
+  term.print("\x1b[30m");
+  CHECK_EQ(shield.mcp.backlight(), 0x0);
+  CHECK_STR(shield.lcd.row(0), "red             ");
+}
+
+TEST(terminal_coalesces_and_throttles) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  uint8_t fb[LCD_SHADOW_SIZE(16, 2)];
+  lcd.begin(16, 2);
+  RGBLCDTerminal term(lcd, fb);
+  term.begin();
+
+  FakeSerial serial;
+  serial.feed("ok");
+  term.update(serial);
+  CHECK_STR(serial.out, ""); // little input, no flow control
+  CHECK_STR(shield.lcd.row(0), "ok              ");
+
+  // A long stream: only the final screen goes over the bus, in one pass,
+  // while the sender is stopped.
+  for (int i = 0; i < 15; i++)
+    serial.feed("\r\nline of text ");
+  serial.feed("\r\nlast");
+  bus.clearLog();
+  term.update(serial);
+  CHECK_STR(serial.out, "\x13\x11");
+  CHECK_STR(shield.lcd.row(0), "line of text    ");
+  CHECK_STR(shield.lcd.row(1), "last            ");
+  CHECK(bus.logBytes() < 3 * 2 + 32 * 4 + 4 * 6);
+
+  // nothing new, nothing sent
+  bus.clearLog();
+  term.update(serial);
+  CHECK_EQ(bus.logStarts(), 0);
+
+  // A burst at 115200 baud during the update of the full screen, which
+  // takes more than 100 byte times at 100 kHz: the sender is stopped
+  // before the 64 bytes of the receive buffer run over, and only resumed
+  // after the input waiting has been shown.
+  serial.out.clear();
+  serial.peak = 0;
+  serial.feed("\f0123456789\r\nabcdefghij");
+  for (int i = 0; i < 6; i++)
+    serial.arrive("\r\nline of text ", 86806);
+  serial.arrive("\r\nend", 86806);
+  term.update(serial);
+  CHECK_STR(serial.out, "\x13");
+  CHECK(serial.available() >= RGBLCD_TERM_XON_AT);
+  term.update(serial);
+  CHECK_STR(serial.out, "\x13\x11");
+  for (int i = 0; i < 10; i++) {
+    emu::advance(2000000);
+    term.update(serial);
+  }
+  CHECK(serial.line.empty());
+  CHECK_EQ(serial.available(), 0);
+  CHECK(serial.peak < 64);
+  CHECK_EQ(serial.out.size() % 2, 0); // resumed in the end
+  CHECK_STR(shield.lcd.row(0), "line of text    ");
+  CHECK_STR(shield.lcd.row(1), "end             ");
+  CHECK_EQ(shield.lcd.violations, 0);
+}
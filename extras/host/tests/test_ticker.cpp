@@ -0,0 +1,125 @@
+/*!
+ * @file test_ticker.cpp
+ *
+ * Marquee on the display shift.
+ */
+
+#include "test.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+#include <RGBLCDTicker.h>
+
+// What the row should show after n steps: the text followed by blanks,
+// repeated every period columns.
+static std::string expected(const char *text, unsigned period, unsigned n,
+                            unsigned cols = 16) {
+  std::string s;
+  for (unsigned c = 0; c < cols; c++) {
+    unsigned i = (n + c) % period;
+    s += (i < strlen(text)) ? text[i] : ' ';
+  }
+  return s;
+}
+
+TEST(ticker_short_text_needs_no_refill) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setCursor(0, 1);
+  lcd.print("static");
+
+  const char text[] = "Short news";
+  RGBLCDTicker ticker(lcd, 0);
+  ticker.begin(text);
+  CHECK_STR(shield.lcd.row(0), "Short news      ");
+  CHECK_STR(shield.lcd.row(1), "static          ");
+
+  for (unsigned n = 1; n <= 100; n++) {
+    bus.clearLog();
+    ticker.step();
+    // one command: address, pointer, RS setup and two nibbles
+    CHECK_EQ(bus.logStarts(), 1);
+    CHECK(bus.logBytes() <= 2u + 5);
+    CHECK_STR(shield.lcd.row(0), expected(text, 40, n));
+    CHECK_EQ(ticker.shift(), n % 40);
+  }
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(ticker_long_text_refills_one_column) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+
+  const char text[] = "The quick brown fox jumps over the lazy dog, "
+                      "and then it runs away from the farmer.";
+  const unsigned period = strlen(text) + 16;
+  RGBLCDTicker ticker(lcd, 1);
+  ticker.begin(text);
+  CHECK_STR(shield.lcd.row(1), "The quick brown ");
+
+  unsigned maxBytes = 0, totalBytes = 0;
+  for (unsigned n = 1; n <= 3 * period; n++) {
+    bus.clearLog();
+    ticker.step();
+    CHECK_EQ(bus.logStarts(), 1);
+    maxBytes = std::max<unsigned>(maxBytes, bus.logBytes());
+    totalBytes += bus.logBytes();
+    CHECK_STR(shield.lcd.row(1), expected(text, period, n));
+  }
+  // shift, address command and one character
+  CHECK(maxBytes <= 2u + 5 + 5 + 6);
+  CHECK(totalBytes < 3 * period * 16);
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(ticker_pgm_and_restart) {
+  static const char text[] PROGMEM = "Flash text which is longer than 40 "
+                                     "columns of DDRAM";
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(20, 2);
+
+  RGBLCDTicker ticker(lcd, 0);
+  ticker.begin("first");
+  for (int n = 0; n < 7; n++)
+    ticker.step();
+  ticker.beginPgm(text);
+  CHECK_EQ(ticker.shift(), 0);
+  CHECK_STR(shield.lcd.row(0, 20), "Flash text which is ");
+  const unsigned period = strlen(text) + 20;
+  for (unsigned n = 1; n <= period; n++)
+    ticker.step();
+  CHECK_STR(shield.lcd.row(0, 20), "Flash text which is ");
+  ticker.step();
+  CHECK_STR(shield.lcd.row(0, 20), "lash text which is l");
+}
+
+TEST(ticker_on_the_lower_rows_of_20x4) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(20, 4);
+
+  // rows 2 and 3 are the second half of the DDRAM lines of rows 0 and 1
+  const char text[] = "Lower row ticker with a text longer than the line";
+  const unsigned period = strlen(text) + 20;
+  for (uint8_t row = 2; row < 4; row++) {
+    RGBLCDTicker ticker(lcd, row);
+    ticker.begin(text);
+    CHECK_STR(shield.lcd.row(row, 20), expected(text, period, 0, 20));
+    for (unsigned n = 1; n <= 2 * period; n++) {
+      ticker.step();
+      CHECK_STR(shield.lcd.row(row, 20), expected(text, period, n, 20));
+    }
+    // nothing beyond the end of the DDRAM line
+    for (uint8_t a = 0x28; a < 0x40; a++)
+      CHECK_EQ(shield.lcd.ddram[a], ' ');
+  }
+  CHECK_EQ(shield.lcd.violations, 0);
+}
@@ -0,0 +1,130 @@
+/*!
+ * @file test_utf8.cpp
+ *
+ * UTF-8 decoding into the character ROMs, with CGRAM glyphs as fallback.
+ */
+
+#include "test.h"
+
+#include <Arduino.h>
+#include <RGBLCDGlyphs.h>
+#include <RGBLCDShield_Fast.h>
+
+static const uint8_t symbols[2][8] PROGMEM = {
+    {0x04, 0x0e, 0x04, 0x0e, 0x1f, 0x0e, 0x00, 0x00}, // snowman
+    {0x06, 0x09, 0x1c, 0x08, 0x1c, 0x09, 0x06, 0x00}, // euro
+};
+static const uint16_t symbolCodes[2] PROGMEM = {0x2603, 0x20ac};
+
+static bool anyRead(const emu::Bus &bus) {
+  for (size_t i = 0; i < bus.log.size(); i++)
+    if (bus.log[i].read)
+      return true;
+  return false;
+}
+
+TEST(utf8_raw_is_the_default) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.print("\xc3\xbc");
+  CHECK_EQ(shield.lcd.ddram[0], 0xc3);
+  CHECK_EQ(shield.lcd.ddram[1], 0xbc);
+}
+
+TEST(utf8_maps_to_a02_rom) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setCharset(LCD_CHARSET_A02);
+  lcd.print("Gr\xc3\xbc\xc3\x9f" "e 20\xc2\xb0" "C \xe2\x86\x92\xce\xa9\\~");
+  CHECK_STR(shield.lcd.row(0), "Gr\xfc\xdf" "e 20\xb0" "C \x1a\x9a\\~ ");
+  lcd.setCursor(0, 1);
+  lcd.print("\xd0\x96\xd0\x90"); // Cyrillic Zhe, A looks like Latin A
+  CHECK_EQ(shield.lcd.ddram[0x40], 0x82);
+  CHECK_EQ(shield.lcd.ddram[0x41], 'A');
+  CHECK_EQ(shield.lcd.violations, 0);
+}
+
+TEST(utf8_maps_to_a00_rom) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setCharset(LCD_CHARSET_A00);
+  // mu, arrow, a umlaut, yen, halfwidth katakana a, backslash, e acute,
+  // one half
+  lcd.print("\xc2\xb5\xe2\x86\x92\xc3\xa4\xc2\xa5\xef\xbd\xb1\\\xc3\xa9\xc2\xbd");
+  CHECK_STR(shield.lcd.row(0), "\xe4\x7e\xe1\x5c\xb1?e?        ");
+}
+
+TEST(utf8_sequences_split_across_writes) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setCharset(LCD_CHARSET_A02);
+  const uint8_t text[] = {'a', 0xe2, 0x86, 0x90, 0xc3, 0xb6, 'b'};
+  lcd.write(text, 2);
+  lcd.write(text[2]);
+  lcd.write(text + 3, 2);
+  lcd.write(text + 5, 2);
+  CHECK_STR(shield.lcd.row(0), "a\x1b\xf6" "b            ");
+}
+
+TEST(utf8_malformed_prints_replacement) {
+  emu::Shield shield;
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setCharset(LCD_CHARSET_A02);
+  // stray continuation, truncated sequence, beyond U+FFFF, CGRAM character
+  lcd.print("\x80" "a\xc3" "b\xf0\x9f\x98\x80" "c\x03");
+  CHECK_STR(shield.lcd.row(0), "?a?b?c\x03         ");
+}
+
+TEST(utf8_write_is_one_burst) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.print("x"); // address counter known
+  bus.clearLog();
+  lcd.print("Grsse");
+  size_t ascii = bus.log.size();
+
+  lcd.setCharset(LCD_CHARSET_A02);
+  lcd.setCursor(1, 0);
+  bus.clearLog();
+  lcd.print("Gr\xc3\xbc\xc3\x9f" "e");
+  CHECK_EQ(bus.log.size(), ascii);
+  CHECK_STR(shield.lcd.row(0), "xGr\xfc\xdf" "e          ");
+}
+
+TEST(utf8_falls_back_to_cgram_glyphs) {
+  emu::Shield shield;
+  emu::Bus &bus = emu::Bus::instance();
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  RGBLCDGlyphs glyphs(lcd, symbols, 2);
+  lcd.setCharset(LCD_CHARSET_A02, &glyphs, symbolCodes);
+  lcd.print("x");
+
+  bus.clearLog();
+  lcd.print("a\xe2\x98\x83" "b\xe2\x82\xac" "c\xe2\x98\x83");
+  CHECK(!anyRead(bus));
+  // the uploads stay in the burst: only the Wire buffer splits it
+  for (size_t i = 0; i + 1 < bus.log.size(); i++)
+    CHECK(bus.log[i].data.size() > 32 - 6);
+  uint8_t snow = shield.lcd.ddram[2], euro = shield.lcd.ddram[4];
+  CHECK(snow < 8 && euro < 8 && snow != euro);
+  CHECK(memcmp(shield.lcd.cgram + 8 * snow, symbols[0], 8) == 0);
+  CHECK(memcmp(shield.lcd.cgram + 8 * euro, symbols[1], 8) == 0);
+  CHECK_EQ(shield.lcd.ddram[6], snow);
+  CHECK_EQ(shield.lcd.ddram[3], 'b');
+  CHECK_EQ(shield.lcd.ddram[5], 'c');
+  CHECK_EQ(shield.lcd.violations, 0);
+
+  // resident glyphs need no upload
+  bus.clearLog();
+  lcd.print("\xe2\x82\xac");
+  CHECK(bus.log.size() == 1);
+  CHECK_EQ(shield.lcd.ddram[7], euro);
+}
@@ -0,0 +1,36 @@
+/*!
+ * @file LinuxArduino.cpp
+ *
+ * Arduino timing functions on the monotonic clock of Linux.
+ */
+
+#include <time.h>
+
+#include <Arduino.h>
+
+static uint64_t nanos(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep(uint64_t ns) {
+  struct timespec ts;
+  ts.tv_sec = ns / 1000000000ull;
+  ts.tv_nsec = ns % 1000000000ull;
+  while (nanosleep(&ts, &ts) != 0) {
+  }
+}
+
+unsigned long millis(void) { return (unsigned long)(nanos() / 1000000ull); }
+
+unsigned long micros(void) { return (unsigned long)(nanos() / 1000ull); }
+
+void delay(unsigned long ms) { sleep((uint64_t)ms * 1000000ull); }
+
+// The waits of the drivers are short, a system call takes about as long.
+void delayMicroseconds(unsigned int us) {
+  uint64_t end = nanos() + (uint64_t)us * 1000ull;
+  while (nanos() < end) {
+  }
+}
@@ -0,0 +1,40 @@
+/*!
+ * @file hello.cpp
+ *
+ * HelloWorld on a Linux board: "./build/hello [device]", the device
+ * defaults to RGBLCD_I2C_DEVICE.  Prints the buttons until SELECT.
+ */
+
+#include <stdio.h>
+
+#include <Arduino.h>
+#include <RGBLCDShield_Fast.h>
+#include <utility/LinuxI2C.h>
+
+int main(int argc, char **argv) {
+  const char *device = (argc > 1) ? argv[1] : RGBLCD_I2C_DEVICE;
+  if (!LinuxWire.begin(device)) {
+    perror(device);
+    return 1;
+  }
+
+  RGBLCDShield_Fast lcd;
+  lcd.begin(16, 2);
+  lcd.setBacklight(0x7);
+  lcd.print("Hello, world!");
+
+  uint8_t buttons;
+  do {
+    buttons = lcd.readButtons();
+    lcd.setCursor(0, 1);
+    lcd.print(millis() / 1000);
+    lcd.print(" ");
+    lcd.print(buttons, HEX);
+    lcd.print("  ");
+    delay(100);
+  } while (!(buttons & BUTTON_SELECT));
+
+  lcd.setBacklight(0x0);
+  lcd.clear();
+  return 0;
+}
@@ -0,0 +1,117 @@
+/***************************************************
+  I2C traffic counters of the RGB LCD shield library
+
+  With RGBLCD_STATS defined, the drivers talk to the bus through
+  RGBLCDCountingBus, which forwards every call to Wire (or TWIM) and adds
+  the traffic to the counters of the current operation.  Without it this
+  header defines nothing and the drivers use the bus directly.
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#ifndef _BUSSTATS_H_
+#define _BUSSTATS_H_
+
+#include <RGBLCDShield_Fast.h>
+
+#ifdef RGBLCD_STATS
+
+extern RGBLCDBusStats rgblcd_bus_stats[LCD_OPS];
+extern uint8_t rgblcd_bus_op; // operation the traffic counts for
+
+// Attributes the bus traffic until the end of the scope to an operation,
+// unless an outer scope already did.
+class RGBLCDStatsScope {
+public:
+  explicit RGBLCDStatsScope(uint8_t op) : outer(rgblcd_bus_op != LCD_OP_OTHER) {
+    if (!outer) {
+      rgblcd_bus_op = op;
+      rgblcd_bus_stats[op].calls++;
+    }
+  }
+  ~RGBLCDStatsScope() {
+    if (!outer)
+      rgblcd_bus_op = LCD_OP_OTHER;
+  }
+
+private:
+  bool outer;
+};
+
+#define LCD_STATS_OP(op) RGBLCDStatsScope stats_scope(op)
+#define LCD_STATS_POLLS(n) (rgblcd_bus_stats[rgblcd_bus_op].polls += (n))
+
+// Counts the bytes, START and STOP conditions passed to the bus.  A byte
+// takes 9 clock cycles with its ACK, START and STOP one each.  Bytes queued
+// for the TWI interrupt count when they are queued, their transactions are
+// not counted.
+template <class W> class RGBLCDCountingBus {
+public:
+  explicit RGBLCDCountingBus(W &wire) : wire(wire) {}
+
+  void begin() { wire.begin(); }
+  void setClock(uint32_t clock) { wire.setClock(clock); }
+
+  void beginTransmission(uint8_t address) {
+    RGBLCDBusStats &s = rgblcd_bus_stats[rgblcd_bus_op];
+    s.starts++;
+    s.bits += 1 + 9;
+    wire.beginTransmission(address);
+  }
+  size_t write(uint8_t data) { return count(wire.write(data)); }
+  size_t write(const uint8_t *data, size_t quantity) {
+    return count(wire.write(data, quantity));
+  }
+  void send(uint8_t data) {
+    wire.send(data);
+    count(1);
+  }
+  uint8_t endTransmission() {
+    RGBLCDBusStats &s = rgblcd_bus_stats[rgblcd_bus_op];
+    s.transactions++;
+    s.bits += 1;
+    return wire.endTransmission();
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+    uint8_t n = wire.requestFrom(address, quantity);
+    RGBLCDBusStats &s = rgblcd_bus_stats[rgblcd_bus_op];
+    s.starts++;
+    s.transactions++;
+    s.read += n;
+    s.bits += 1 + 9 + 9 * n + 1;
+    return n;
+  }
+  int read() { return wire.read(); }
+  uint8_t receive() { return wire.receive(); }
+
+  bool queue(uint8_t address, uint8_t reg, const uint8_t *frame, uint8_t len,
+             uint8_t flags, uint8_t policy) {
+    if (!wire.queue(address, reg, frame, len, flags, policy))
+      return false;
+    count(len);
+    return true;
+  }
+  bool busy() { return wire.busy(); }
+  uint8_t pending() { return wire.pending(); }
+  void waitIdle() { wire.waitIdle(); }
+
+private:
+  size_t count(size_t n) {
+    RGBLCDBusStats &s = rgblcd_bus_stats[rgblcd_bus_op];
+    s.written += n;
+    s.bits += 9 * n;
+    return n;
+  }
+
+  W &wire;
+};
+
+#else
+
+#define LCD_STATS_OP(op)
+#define LCD_STATS_POLLS(n)
+
+#endif
+
+#endif
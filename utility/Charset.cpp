@@ -0,0 +1,197 @@
+/***************************************************
+  Character ROM tables of the RGB LCD shield library
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#include "Charset.h"
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+// Code points first .. first + count - 1, their codes start at offset.
+struct CharBlock {
+  uint16_t first;
+  uint8_t count;
+  uint8_t offset;
+};
+
+static const uint8_t a00_codes[] PROGMEM = {
+    // U+00A2..U+00A5
+    0xec, 0xed, 0x00, 0x5c,
+    // U+00B0..U+00B7
+    0xdf, 0x00, 0x00, 0x00, 0x00, 0xe4, 0x00, 0xa5,
+    // U+00E4..U+00E4
+    0xe1,
+    // U+00F1..U+00FC
+    0xee, 0x00, 0x00, 0x00, 0x00, 0xef, 0xfd, 0x00, 0x00, 0x00, 0x00, 0xf5,
+    // U+03A3..U+03A9
+    0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf4,
+    // U+03B1..U+03C3
+    0xe0, 0xe2, 0x00, 0x00, 0xe3, 0x00, 0x00, 0xf2, 0x00, 0x00, 0x00, 0xe4,
+    0x00, 0x00, 0x00, 0xf7, 0xe6, 0x00, 0xe5,
+    // U+0410..U+0425
+    0x41, 0x00, 0x42, 0x00, 0x00, 0x45, 0x00, 0x00, 0x00, 0x00, 0x4b, 0x00,
+    0x4d, 0x48, 0x4f, 0x00, 0x50, 0x43, 0x54, 0x00, 0x00, 0x58,
+    // U+0430..U+0435
+    0x61, 0x00, 0x00, 0x00, 0x00, 0x65,
+    // U+043E..U+0445
+    0x6f, 0x00, 0x70, 0x63, 0x00, 0x79, 0x00, 0x78,
+    // U+2190..U+2192
+    0x7f, 0x00, 0x7e,
+    // U+221A..U+221E
+    0xe8, 0x00, 0x00, 0x00, 0xf3,
+    // U+2588..U+2588
+    0xff,
+};
+
+static const CharBlock a00_blocks[] PROGMEM = {
+    {0x00a2, 4, 0},
+    {0x00b0, 8, 4},
+    {0x00e4, 1, 12},
+    {0x00f1, 12, 13},
+    {0x03a3, 7, 25},
+    {0x03b1, 19, 32},
+    {0x0410, 22, 51},
+    {0x0430, 6, 73},
+    {0x043e, 8, 79},
+    {0x2190, 3, 87},
+    {0x221a, 5, 90},
+    {0x2588, 1, 95},
+};
+
+static const uint8_t a02_codes[] PROGMEM = {
+    // U+00A1..U+00FF
+    0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0x00, 0xa9, 0xaa, 0xab, 0x00,
+    0x00, 0xae, 0x00, 0xb0, 0xb1, 0xb2, 0xb3, 0x00, 0xb5, 0xb6, 0xb7, 0x00,
+    0xb9, 0xba, 0xbb, 0x00, 0x00, 0x00, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4,
+    0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0,
+    0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0x00, 0xd9, 0xda, 0xdb, 0xdc,
+    0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8,
+    0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4,
+    0xf5, 0xf6, 0xf7, 0x00, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+    // U+0393..U+0398
+    0x92, 0x00, 0x00, 0x00, 0x00, 0x99,
+    // U+03A3..U+03A9
+    0x94, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9a,
+    // U+03B1..U+03B5
+    0x90, 0x00, 0x00, 0x9b, 0x9e,
+    // U+03BC..U+03C4
+    0xb5, 0x00, 0x00, 0x00, 0x93, 0x00, 0x00, 0x95, 0x97,
+    // U+0410..U+0435
+    0x41, 0x80, 0x42, 0x00, 0x81, 0x45, 0x82, 0x83, 0x84, 0x85, 0x4b, 0x86,
+    0x4d, 0x48, 0x4f, 0x87, 0x50, 0x43, 0x54, 0x88, 0x00, 0x58, 0x89, 0x8a,
+    0x8b, 0x8c, 0x8d, 0x8e, 0x00, 0x8f, 0x00, 0x00, 0x61, 0x00, 0x00, 0x00,
+    0x00, 0x65,
+    // U+043E..U+0445
+    0x6f, 0x00, 0x70, 0x63, 0x00, 0x79, 0x00, 0x78,
+    // U+201C..U+201D
+    0x12, 0x13,
+    // U+2190..U+2193
+    0x1b, 0x18, 0x1a, 0x19,
+    // U+21B5..U+21B5
+    0x17,
+    // U+221E..U+221E
+    0x9c,
+    // U+2229..U+2229
+    0x9f,
+    // U+2264..U+2265
+    0x1c, 0x1d,
+    // U+2302..U+2302
+    0x7f,
+    // U+23EB..U+23EC
+    0x14, 0x15,
+    // U+25B2..U+25C0
+    0x1e, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x00,
+    0x00, 0x00, 0x11,
+    // U+25CF..U+25CF
+    0x16,
+    // U+2665..U+266C
+    0x9d, 0x00, 0x00, 0x00, 0x00, 0x91, 0x00, 0x96,
+};
+
+static const CharBlock a02_blocks[] PROGMEM = {
+    {0x00a1, 95, 0},
+    {0x0393, 6, 95},
+    {0x03a3, 7, 101},
+    {0x03b1, 5, 108},
+    {0x03bc, 9, 113},
+    {0x0410, 38, 122},
+    {0x043e, 8, 160},
+    {0x201c, 2, 168},
+    {0x2190, 4, 170},
+    {0x21b5, 1, 174},
+    {0x221e, 1, 175},
+    {0x2229, 1, 176},
+    {0x2264, 2, 177},
+    {0x2302, 1, 179},
+    {0x23eb, 2, 180},
+    {0x25b2, 15, 182},
+    {0x25cf, 1, 197},
+    {0x2665, 8, 198},
+};
+
+static const uint8_t ascii_codes[] PROGMEM = {
+    // U+00A0..U+00A0
+    0x20,
+    // U+00A9..U+00B0
+    0x63, 0x00, 0x3c, 0x00, 0x00, 0x52, 0x00, 0x6f,
+    // U+00B7..U+00FF
+    0x2e, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00, 0x00, 0x41, 0x41, 0x41,
+    0x41, 0x41, 0x41, 0x45, 0x43, 0x45, 0x45, 0x45, 0x45, 0x49, 0x49, 0x49,
+    0x49, 0x44, 0x4e, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x78, 0x4f, 0x55, 0x55,
+    0x55, 0x55, 0x59, 0x50, 0x73, 0x61, 0x61, 0x61, 0x61, 0x61, 0x61, 0x65,
+    0x63, 0x65, 0x65, 0x65, 0x65, 0x69, 0x69, 0x69, 0x69, 0x64, 0x6e, 0x6f,
+    0x6f, 0x6f, 0x6f, 0x6f, 0x3a, 0x6f, 0x75, 0x75, 0x75, 0x75, 0x79, 0x70,
+    0x79,
+    // U+2010..U+201F
+    0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x00, 0x00, 0x27, 0x27, 0x27, 0x27,
+    0x22, 0x22, 0x22, 0x22,
+};
+
+static const CharBlock ascii_blocks[] PROGMEM = {
+    {0x00a0, 1, 0},
+    {0x00a9, 8, 1},
+    {0x00b7, 73, 9},
+    {0x2010, 16, 82},
+};
+
+#define BLOCKS(table) (sizeof(table) / sizeof(table[0]))
+
+// Blocks are sorted, so the scan stops at the first one past cp.
+static uint8_t lookup(uint16_t cp, const CharBlock *blocks, uint8_t n,
+                      const uint8_t *codes) {
+  for (uint8_t i = 0; i < n; i++) {
+    uint16_t first = pgm_read_word(&blocks[i].first);
+    if (cp < first)
+      break;
+    if (cp - first < pgm_read_byte(&blocks[i].count))
+      return pgm_read_byte(codes + pgm_read_byte(&blocks[i].offset) +
+                           (cp - first));
+  }
+  return 0;
+}
+
+uint8_t rgblcd_rom_code(uint16_t cp, uint8_t charset) {
+  if (cp >= 0x20 && cp < 0x7f) {
+    // A00 has the yen sign and an arrow in place of backslash and tilde
+    if (charset == LCD_CHARSET_A00 && (cp == '\\' || cp == '~'))
+      return 0;
+    return cp;
+  }
+  if (charset == LCD_CHARSET_A00) {
+    if (cp >= 0xff61 && cp <= 0xff9f) // halfwidth katakana
+      return cp - 0xff61 + 0xa1;
+    return lookup(cp, a00_blocks, BLOCKS(a00_blocks), a00_codes);
+  }
+  if (charset == LCD_CHARSET_A02)
+    return lookup(cp, a02_blocks, BLOCKS(a02_blocks), a02_codes);
+  return 0;
+}
+
+uint8_t rgblcd_ascii(uint16_t cp) {
+  return lookup(cp, ascii_blocks, BLOCKS(ascii_blocks), ascii_codes);
+}
@@ -0,0 +1,28 @@
+/***************************************************
+  Character ROM tables of the RGB LCD shield library
+
+  Maps Unicode code points to the character codes of the HD44780 ROMs A00
+  (Japanese) and A02 (European).  The tables live in PROGMEM as a short
+  list of blocks of code points with one byte per code point, so a lookup
+  scans at most a few block headers and reads a single byte.  Code 0
+  stands for "no glyph": the codes 0..7 are the CGRAM characters.
+
+  Displays labelled A00 or A02 by different makers do not always agree on
+  the rarely used codes.  The tables only contain glyphs found in the
+  Hitachi datasheet, ASCII and Latin-1 letters without a glyph have an
+  ASCII approximation.
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#ifndef _CHARSET_H_
+#define _CHARSET_H_
+
+#include <RGBLCDShield_Fast.h>
+
+// Character code of a code point in the ROM of the charset, 0 if none.
+uint8_t rgblcd_rom_code(uint16_t cp, uint8_t charset);
+// ASCII character resembling a code point, e.g. 'e' for U+00E9, 0 if none.
+uint8_t rgblcd_ascii(uint16_t cp);
+
+#endif
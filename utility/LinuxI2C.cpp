@@ -0,0 +1,168 @@
+/***************************************************
+  I2C master on Linux i2c-dev with I2C_RDWR batching
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#include "LinuxI2C.h"
+
+#ifdef RGBLCD_LINUX_I2C
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Longest message i2c-dev accepts
+#define MAX_MESSAGE 8192
+
+LinuxI2C LinuxWire;
+
+static int rdwr(int fd, struct i2c_msg *msgs, unsigned count) {
+  struct i2c_rdwr_ioctl_data data;
+  data.msgs = msgs;
+  data.nmsgs = count;
+  return ioctl(fd, I2C_RDWR, &data);
+}
+
+LinuxI2C::LinuxI2C()
+    : fd(-1), transfer(rdwr), calls(0), buf(NULL), size(0), capacity(0),
+      count(0), building(false), status(0), rxIndex(0), rxLength(0) {}
+
+LinuxI2C::~LinuxI2C() {
+  end();
+  free(buf);
+}
+
+bool LinuxI2C::begin(const char *device) {
+  end();
+  fd = ::open(device, O_RDWR);
+  return fd >= 0;
+}
+
+void LinuxI2C::begin() {
+  if (fd < 0)
+    begin(RGBLCD_I2C_DEVICE);
+}
+
+void LinuxI2C::end() {
+  flush();
+  if (fd >= 0)
+    close(fd);
+  fd = -1;
+}
+
+void LinuxI2C::setTransfer(Transfer t) {
+  flush();
+  transfer = t ? t : rdwr;
+}
+
+void LinuxI2C::beginTransmission(uint8_t address) {
+  if (count == I2C_RDWR_IOCTL_MAX_MSGS)
+    flush();
+  msgs[count].addr = address;
+  msgs[count].flags = 0;
+  msgs[count].len = 0;
+  offset[count] = size;
+  building = true;
+  status = 0;
+}
+
+// Makes room for n more bytes of message data.
+bool LinuxI2C::reserve(size_t n) {
+  if (size + n <= capacity)
+    return true;
+  size_t c = capacity ? 2 * capacity : 256;
+  while (c < size + n)
+    c *= 2;
+  uint8_t *b = (uint8_t *)realloc(buf, c);
+  if (!b)
+    return false;
+  buf = b;
+  capacity = c;
+  return true;
+}
+
+size_t LinuxI2C::write(uint8_t data) {
+  if (!building || status != 0)
+    return 0;
+  if (msgs[count].len >= MAX_MESSAGE || !reserve(1)) {
+    status = 1; // data too long
+    return 0;
+  }
+  buf[size++] = data;
+  msgs[count].len++;
+  return 1;
+}
+
+size_t LinuxI2C::write(const uint8_t *data, size_t quantity) {
+  if (!building || status != 0)
+    return 0;
+  if (msgs[count].len + quantity > MAX_MESSAGE || !reserve(quantity)) {
+    status = 1;
+    return 0;
+  }
+  memcpy(buf + size, data, quantity);
+  size += quantity;
+  msgs[count].len += quantity;
+  return quantity;
+}
+
+uint8_t LinuxI2C::endTransmission(uint8_t sendStop) {
+  if (!building)
+    return 4;
+  building = false;
+  if (status != 0) {
+    size = offset[count]; // drop the message
+    return status;
+  }
+  // A write of just the register pointer only matters for what follows.
+  if (!sendStop || msgs[count].len == 1) {
+    count++;
+    return 0;
+  }
+  count++;
+  return flush() ? 0 : 4;
+}
+
+uint8_t LinuxI2C::requestFrom(uint8_t address, uint8_t quantity) {
+  if (quantity > sizeof(rxBuffer))
+    quantity = sizeof(rxBuffer);
+  if (count == I2C_RDWR_IOCTL_MAX_MSGS)
+    flush();
+  msgs[count].addr = address;
+  msgs[count].flags = I2C_M_RD;
+  msgs[count].len = quantity;
+  msgs[count].buf = rxBuffer;
+  count++;
+  rxIndex = 0;
+  rxLength = flush() ? quantity : 0;
+  return rxLength;
+}
+
+int LinuxI2C::available() {
+  return rxLength - rxIndex;
+}
+
+int LinuxI2C::read() {
+  if (rxIndex < rxLength)
+    return rxBuffer[rxIndex++];
+  return -1;
+}
+
+// Sends all pending messages in one ioctl, with repeated STARTs in between.
+bool LinuxI2C::flush() {
+  if (count == 0)
+    return true;
+  for (unsigned i = 0; i < count; i++)
+    if (!(msgs[i].flags & I2C_M_RD))
+      msgs[i].buf = buf + offset[i];
+  calls++;
+  int ret = transfer(fd, msgs, count);
+  count = 0;
+  size = 0;
+  return ret >= 0;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/***************************************************
+  I2C master on Linux i2c-dev with I2C_RDWR batching
+
+  The interface follows the Wire library, so the drivers only need to swap
+  the object they talk to.  Transactions are not limited to 32 bytes, a
+  whole screen goes into a single message.  A write which only sets the
+  register pointer is held back and sent in the same ioctl as the next
+  transfer, with a repeated START in between: a register read costs one
+  system call.  endTransmission(false) holds back any write like that.
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#ifndef _LINUXI2C_H_
+#define _LINUXI2C_H_
+
+#include <RGBLCDShield_Fast_config.h>
+#include <inttypes.h>
+#include <stddef.h>
+
+#ifdef RGBLCD_LINUX_I2C
+
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+
+class LinuxI2C {
+public:
+  // Performs the I2C_RDWR ioctl, returns a negative value on error.  Tests
+  // replace it to talk to an emulated device.
+  typedef int (*Transfer)(int fd, struct i2c_msg *msgs, unsigned count);
+
+  LinuxI2C();
+  ~LinuxI2C();
+
+  bool begin(const char *device);
+  void begin(); // opens RGBLCD_I2C_DEVICE unless a device is open
+  void end();
+  void setClock(uint32_t) {} // set by the bus driver of the kernel
+  void setTransfer(Transfer transfer);
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t quantity);
+  uint8_t endTransmission(uint8_t sendStop = true);
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity);
+  int available();
+  int read();
+
+  unsigned long transfers() const { return calls; } // ioctls so far
+
+private:
+  bool reserve(size_t n);
+  bool flush();
+
+  int fd;
+  Transfer transfer;
+  unsigned long calls;
+
+  // data of the pending messages, which only point into it when sent
+  uint8_t *buf;
+  size_t size, capacity;
+  struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+  size_t offset[I2C_RDWR_IOCTL_MAX_MSGS];
+  unsigned count;
+  bool building;  // the last message still takes data
+  uint8_t status; // error of the current transmission
+
+  uint8_t rxBuffer[32];
+  uint8_t rxIndex;
+  uint8_t rxLength;
+};
+
+extern LinuxI2C LinuxWire;
+
+#endif
+
+#endif
@@ -15,24 +15,45 @@
 
  ****************************************************/
 
+#include <RGBLCDShield_Fast_config.h>
+#ifdef RGBLCD_TWI
+#include "TWIMaster.h"
+#define WIRE TWIM
+#elif defined(RGBLCD_LINUX_I2C)
+#include "LinuxI2C.h"
+#define WIRE LinuxWire
+#else
 #include <Wire.h>
+#endif
 #ifdef __AVR
 #include <avr/pgmspace.h>
 #elif defined(ESP8266)
 #include <pgmspace.h>
 #endif
 #include "MCP23017.h"
+#ifndef WIRE
 #ifdef __SAM3X8E__ // Arduino Due
 #define WIRE Wire1
 #else
 #define WIRE Wire
 #endif
+#endif
+#include "BusStats.h"
+#ifdef RGBLCD_STATS
+static RGBLCDCountingBus<decltype(WIRE)> countingBus(WIRE);
+#undef WIRE
+#define WIRE countingBus
+#endif
 
 #if ARDUINO >= 100
 #include "Arduino.h"
 #else
 #include "WProgram.h"
 #endif
+#include <string.h>
+
+// index of OLAT in the register cache
+#define CACHE_OLAT 7
 
 // minihelper
 static inline void wiresend(uint8_t x) {
@@ -57,7 +78,48 @@ MCP23017::MCP23017() {
   mode = -1;  // we just don't know yet
 }
 
-void MCP23017::begin(uint8_t addr) {
+// Returns the cache entry of register reg at its address in the current
+// mode, or NULL if it is not cached.
+uint8_t *MCP23017::cached(uint8_t reg) {
+  uint8_t port, index;
+
+  if (mode == 0) {
+    port = reg & 0x01;
+    index = reg >> 1;
+  } else if (mode == 1) {
+    port = reg >> 4;
+    index = reg & 0x0f;
+  } else {
+    return NULL;
+  }
+  if (port > 1)
+    return NULL;
+  if (index == (MCP23017_SEQ_GPIOA >> 1) || index == (MCP23017_SEQ_OLATA >> 1))
+    index = CACHE_OLAT; // writes to GPIO go to the output latch
+  else if (index > (MCP23017_SEQ_GPPUA >> 1))
+    return NULL; // INTF and INTCAP are read-only
+  return &cache[port][index];
+}
+
+// Writes all cached registers in a single sequential transaction.
+// Requires mode 0.
+void MCP23017::writeCache() {
+  WIRE.beginTransmission(MCP23017_ADDRESS | i2caddr);
+  wiresend(MCP23017_SEQ_IODIRA);
+  for (uint8_t reg = MCP23017_SEQ_IODIRA; reg <= MCP23017_SEQ_OLATB; reg++) {
+    uint8_t *c = cached(reg);
+    // INTF and INTCAP are read-only, the written value does not matter
+    wiresend(c ? *c : 0);
+  }
+  WIRE.endTransmission();
+}
+
+// Resets the chip to the power-on state, except for the given direction,
+// pull-up and output latch of all pins (port B in the high byte), with three
+// writes.  Returns true if the chip was still in burst mode, i.e. it
+// kept its state since a previous begin().
+bool MCP23017::begin(uint8_t addr, uint16_t iodir, uint16_t gppu,
+                     uint16_t olat) {
   if (addr > 7) {
     addr = 7;
   }
@@ -69,27 +131,51 @@ void MCP23017::begin(uint8_t addr) {
 #endif
     WIRE.begin();
 
-  // We may be in "burst" or normal mode. Revert to bank=0, seq=0.
-  // Assume we are in BANK=1 mode:
-  // Clear BANK bit. This might also be GPINTENB.GPINT7 if we are in BANK=0 mode.
-  updateRegister(MCP23017_BANK_IOCONA, 0x80, false);
+  // In BANK=1 mode both addresses hold IOCON, in BANK=0 mode they are
+  // GPINTENB and OLATB, which are zero after power-on.
+  mode = -1;
+  uint8_t iocon = readRegister(MCP23017_BANK_IOCONA);
+  bool warm = (iocon & (0x80 | 0x20)) == (0x80 | 0x20) &&
+              readRegister(MCP23017_BANK_IOCONB) == iocon;
+
+  memset(cache, 0, sizeof(cache));
+  cache[0][MCP23017_SEQ_IODIRA >> 1] = iodir & 0xff;
+  cache[1][MCP23017_SEQ_IODIRA >> 1] = iodir >> 8;
+  cache[0][MCP23017_SEQ_GPPUA >> 1] = gppu & 0xff;
+  cache[1][MCP23017_SEQ_GPPUA >> 1] = gppu >> 8;
+  cache[0][CACHE_OLAT] = olat & 0xff;
+  cache[1][CACHE_OLAT] = olat >> 8;
+  resync();
+  return warm;
+}
 
-  // Finally, we also clear the increment address bit:
-  writeRegister(MCP23017_SEQ_IOCONA, 0x00);
+bool MCP23017::begin(void) {
+  return begin(0);
+}
 
-  // We are in mode == 0 now.
+// Writes the cached state back to the chip, e.g. after it has been reset by
+// someone else.
+void MCP23017::resync() {
+  uint8_t burst = (mode == 1);
+
+  // We may be in "burst" or normal mode. Revert to bank=0, seq=0.
+  // Assume we are in BANK=1 mode: clear IOCON.  This is GPINTENB if we are
+  // in BANK=0 mode already, which is rewritten below anyway.
+  mode = -1;
+  writeRegister(MCP23017_BANK_IOCONA, 0x00);
+  // Now we are in BANK=0 mode. Also clear the increment address bit:
+  writeRegister(MCP23017_SEQ_IOCONA, 0x00);
   mode = 0;
-  // Update register variables.
-  normalMode();
 
-  // set defaults!
-  writeRegister(IODIRA, 0xff); // all inputs on port A
-  writeRegister(IODIRB, 0xff); // all inputs on port B
+  uint8_t iocon = cache[0][MCP23017_SEQ_IOCONA >> 1];
+  cache[0][MCP23017_SEQ_IOCONA >> 1] = cache[1][MCP23017_SEQ_IOCONA >> 1] =
+      iocon & ~(0x80 | 0x20);
+  writeCache();
+  normalMode();
+  if (burst)
+    burstMode();
 }
 
-void MCP23017::begin(void) {
-  begin(0);
-}
 
 void MCP23017::pinMode(uint8_t p, uint8_t d) {
   uint8_t iodiraddr;
@@ -163,33 +249,42 @@ void MCP23017::writeGPIOAB(uint16_t ba) {
     wiresend(ba & 0xFF);
     wiresend(ba >> 8);
     WIRE.endTransmission();
+    cache[0][CACHE_OLAT] = ba & 0xFF;
+    cache[1][CACHE_OLAT] = ba >> 8;
   } else {
     writeGPIOA(ba & 0xFF);
     writeGPIOB(ba >> 8);
   }
 }
 
+// Changes the output latches of the pins in mask.  Ports which do not
+// change are not written.
+void MCP23017::updateGPIOAB(uint16_t mask, uint16_t value) {
+  uint8_t a = (cache[0][CACHE_OLAT] & ~mask) | (value & mask);
+  uint8_t b = (cache[1][CACHE_OLAT] & ~(mask >> 8)) | ((value & mask) >> 8);
+  if (a != cache[0][CACHE_OLAT])
+    writeGPIOA(a);
+  if (b != cache[1][CACHE_OLAT])
+    writeGPIOB(b);
+}
+
 void MCP23017::digitalWrite(uint8_t p, uint8_t d) {
   uint8_t gpio;
-  uint8_t gpioaddr, olataddr;
+  uint8_t gpioaddr;
 
   // only 16 bits!
   if (p > 15)
     return;
 
   if (p < 8) {
-    olataddr = OLATA;
+    gpio = cache[0][CACHE_OLAT];
     gpioaddr = GPIOA;
   } else {
-    olataddr = OLATB;
+    gpio = cache[1][CACHE_OLAT];
     gpioaddr = GPIOB;
     p -= 8;
   }
 
-  // update GPIO output latches
-  //updateRegister(olataddr, (1 << p), (d == HIGH))
-  gpio = readRegister(olataddr);
-
   // set the pin and direction
   if (d == HIGH) {
     gpio |= 1 << p;
@@ -241,8 +336,9 @@ void MCP23017::normalMode() {
   if (mode != 0) {
     // First, we assume we are in BANK=1 mode.
     // Caution: this changes all register locations, including the IOCON!
-    writeRegister(MCP23017_BANK_IOCONA, 0x00); // IOCON in BANK=1 mode, // BANK=0, SEQOP=0
-    //writeRegister(MCP23017_BANK_IOCONB, 0x00); // IOCON in BANK=1 mode, // BANK=0, SEQOP=0
+    // IOCON in BANK=1 mode, BANK=0, SEQOP=0, other bits are kept
+    writeRegister(MCP23017_BANK_IOCONA,
+                  cache[0][MCP23017_SEQ_IOCONA >> 1] & ~(0x80 | 0x20));
   }
   mode = 0;
 
@@ -277,12 +373,14 @@ void MCP23017::burstMode() {
   // This allows repeated access to the same register within a single I2C transition.
 
   if (mode != 1) {
+    uint8_t iocon = cache[0][MCP23017_SEQ_IOCONA >> 1] & ~(0x80 | 0x20);
     // First, we assume we are in BANK=0 mode.
     // Caution: this changes all register locations, including the IOCON!
-    writeRegister(MCP23017_SEQ_IOCONA, 0x80); // IOCON in BANK=0 mode,  BANK=1, SEQOP=0
-    // Make sure we are in non-sequential mode
-    writeRegister(MCP23017_BANK_IOCONA, 0x80 | 0x20); // IOCON in BANK=1 mode,  BANK=1, SEQOP=1
-      // Byte mode w/o sequential addressing
+    // IOCON in BANK=0 mode, BANK=1, SEQOP=1: byte mode w/o sequential
+    // addressing
+    writeRegister(MCP23017_SEQ_IOCONA, iocon | 0x80 | 0x20);
+    mode = 1;
+    cacheRegister(MCP23017_BANK_IOCONA, iocon | 0x80 | 0x20);
   }
   mode = 1;
 
@@ -317,7 +415,7 @@ uint8_t MCP23017::readRegister(uint8_t reg)
   WIRE.beginTransmission(MCP23017_ADDRESS | i2caddr);
   wiresend(reg);
   WIRE.endTransmission();
-  WIRE.requestFrom(MCP23017_ADDRESS, 1);
+  WIRE.requestFrom(MCP23017_ADDRESS | i2caddr, 1);
   return wirerecv();
 }
 
@@ -327,11 +425,27 @@ void MCP23017::writeRegister(uint8_t reg, uint8_t val)
   wiresend(reg);
   wiresend(val);
   WIRE.endTransmission();
+  cacheRegister(reg, val);
+}
+
+// Tells the cache about a value the caller wrote to reg directly.
+void MCP23017::cacheRegister(uint8_t reg, uint8_t val)
+{
+  uint8_t *c = cached(reg);
+  if (c) {
+    *c = val;
+    // IOCON is shared by both ports
+    if (c == &cache[0][MCP23017_SEQ_IOCONA >> 1] ||
+        c == &cache[1][MCP23017_SEQ_IOCONA >> 1])
+      cache[0][MCP23017_SEQ_IOCONA >> 1] = cache[1][MCP23017_SEQ_IOCONA >> 1] =
+          val;
+  }
 }
 
 void MCP23017::updateRegister(uint8_t reg, uint8_t mask, bool set)
 {
-  uint8_t val = readRegister(reg);
+  uint8_t *c = cached(reg);
+  uint8_t val = c ? *c : readRegister(reg);
   if (set) {
     val |=  mask;
   } else {
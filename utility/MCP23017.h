@@ -23,8 +23,9 @@ class MCP23017 {
 public:
   MCP23017();
 
-  void begin(uint8_t addr);
-  void begin(void);
+  bool begin(uint8_t addr, uint16_t iodir = 0xffff, uint16_t gppu = 0,
+             uint16_t olat = 0);
+  bool begin(void);
 
   void pinMode(uint8_t p, uint8_t d);
   void digitalWrite(uint8_t p, uint8_t d);
@@ -34,6 +35,7 @@ public:
   void writeGPIOA(uint8_t);
   void writeGPIOB(uint8_t);
   void writeGPIOAB(uint16_t);
+  void updateGPIOAB(uint16_t mask, uint16_t value);
   uint8_t readGPIOA();
   uint8_t readGPIOB();
   uint16_t readGPIOAB();
@@ -44,12 +46,22 @@ public:
   uint8_t readRegister(uint8_t);
   void writeRegister(uint8_t, uint8_t);
   void updateRegister(uint8_t, uint8_t, bool);
+  void cacheRegister(uint8_t, uint8_t);
+  void resync();
 
 private:
+  uint8_t *cached(uint8_t);
+  void writeCache();
+
   uint8_t i2caddr;
   uint8_t mode;  // mode == 0:  auto-increment address, non-banked
                  // mode == 1:  "burst": non address increment, banked register addresses
 
+  // Write-through copy of the configuration and output latches of both
+  // ports: IODIR, IPOL, GPINTEN, DEFVAL, INTCON, IOCON, GPPU, OLAT.
+  // Registers are never read back for a read-modify-write.
+  uint8_t cache[2][8];
+
 public:
   uint8_t IODIRA;
   uint8_t IPOLA;
@@ -0,0 +1,240 @@
+/***************************************************
+  Minimal TWI master for AVR with an optional interrupt driven transmit queue
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#include "TWIMaster.h"
+#include "TWIQueue.h"
+
+#ifdef RGBLCD_TWI
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <compat/twi.h>
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#ifndef TWCR
+#error "RGBLCD_TWI requires an AVR with TWI hardware"
+#endif
+
+TWIMaster TWIM;
+
+#ifdef RGBLCD_TWI_ASYNC
+
+// Frames waiting for the interrupt, see TWIQueue.h
+static TWIQueue q;
+static volatile bool q_active; // the interrupt owns the bus
+static uint8_t q_addr, q_reg;
+
+// frame being transmitted, only used by the interrupt
+static uint8_t q_frame[TWI_FRAME_MAX];
+static uint8_t q_flen, q_fpos;
+
+static inline void q_stop() {
+  TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+  q_active = false;
+}
+
+ISR(TWI_vect) {
+  switch (TW_STATUS) {
+  case TW_START:
+  case TW_REP_START:
+    TWDR = (q_addr << 1) | TW_WRITE;
+    break;
+  case TW_MT_SLA_ACK:
+    TWDR = q_reg;
+    break;
+  case TW_MT_DATA_ACK:
+    if (q_fpos == q_flen) {
+      if (q.count == 0) {
+        q_stop();
+        return;
+      }
+      q_flen = q.pop(q_frame);
+      q_fpos = 0;
+    }
+    TWDR = q_frame[q_fpos++];
+    break;
+  default:
+    // NACK or lost arbitration: the data is of no use anymore
+    q.clear();
+    q_flen = q_fpos = 0;
+    q_stop();
+    return;
+  }
+  TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+}
+
+#endif // RGBLCD_TWI_ASYNC
+
+TWIMaster::TWIMaster() : status(0), twcr(0), rxIndex(0), rxLength(0) {}
+
+static uint8_t twi_wait() {
+  while (!(TWCR & _BV(TWINT)))
+    ;
+  return TW_STATUS;
+}
+
+static inline void twi_stop(uint8_t twcr) {
+  TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+  while (TWCR & _BV(TWSTO))
+    ;
+  // hand the hardware back to Wire
+  TWCR = _BV(TWEN) | twcr;
+}
+
+static uint8_t twi_start(uint8_t sla) {
+  TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN);
+  uint8_t s = twi_wait();
+  if (s != TW_START && s != TW_REP_START)
+    return 4;
+  TWDR = sla;
+  TWCR = _BV(TWINT) | _BV(TWEN);
+  s = twi_wait();
+  if (s != TW_MT_SLA_ACK && s != TW_MR_SLA_ACK)
+    return 2;
+  return 0;
+}
+
+void TWIMaster::begin() {
+  // activate internal pullups for twi, like the Wire library does
+  digitalWrite(SDA, HIGH);
+  digitalWrite(SCL, HIGH);
+  TWSR &= ~(_BV(TWPS0) | _BV(TWPS1));
+  setClock(100000);
+  TWCR = _BV(TWEN);
+}
+
+void TWIMaster::setClock(uint32_t clock) {
+  waitIdle();
+  // SCL = F_CPU / (16 + 2 * TWBR), the prescaler is 1
+  uint32_t div = F_CPU / clock;
+  if (div <= 16)
+    TWBR = 0; // as fast as it goes
+  else if (div >= 16 + 2 * 255)
+    TWBR = 255;
+  else
+    TWBR = (div - 16) / 2;
+}
+
+void TWIMaster::beginTransmission(uint8_t address) {
+  waitIdle();
+  // We poll, so keep the interrupt of Wire out of the way meanwhile.
+  twcr = TWCR & (_BV(TWIE) | _BV(TWEA));
+  status = twi_start((address << 1) | TW_WRITE);
+}
+
+size_t TWIMaster::write(uint8_t data) {
+  if (status != 0)
+    return 0;
+  TWDR = data;
+  TWCR = _BV(TWINT) | _BV(TWEN);
+  if (twi_wait() != TW_MT_DATA_ACK) {
+    status = 3;
+    return 0;
+  }
+  return 1;
+}
+
+size_t TWIMaster::write(const uint8_t *data, size_t quantity) {
+  size_t n = 0;
+  while (quantity-- && write(*data++))
+    n++;
+  return n;
+}
+
+uint8_t TWIMaster::endTransmission() {
+  twi_stop(twcr);
+  return status;
+}
+
+uint8_t TWIMaster::requestFrom(uint8_t address, uint8_t quantity) {
+  if (quantity > sizeof(rxBuffer))
+    quantity = sizeof(rxBuffer);
+  waitIdle();
+  twcr = TWCR & (_BV(TWIE) | _BV(TWEA));
+  rxIndex = rxLength = 0;
+  if (twi_start((address << 1) | TW_READ) != 0) {
+    twi_stop(twcr);
+    return 0;
+  }
+  for (uint8_t i = 0; i < quantity; i++) {
+    // acknowledge all but the last byte
+    if (i + 1 < quantity)
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWEA);
+    else
+      TWCR = _BV(TWINT) | _BV(TWEN);
+    twi_wait();
+    rxBuffer[i] = TWDR;
+  }
+  twi_stop(twcr);
+  rxLength = quantity;
+  return quantity;
+}
+
+int TWIMaster::read() {
+  if (rxIndex < rxLength)
+    return rxBuffer[rxIndex++];
+  return -1;
+}
+
+#ifdef RGBLCD_TWI_ASYNC
+
+bool TWIMaster::queue(uint8_t address, uint8_t reg, const uint8_t *frame,
+                      uint8_t len, uint8_t flags, uint8_t policy) {
+  if (address != q_addr || reg != q_reg) {
+    // the queue only serves a single register of a single device at a time
+    waitIdle();
+    q_addr = address;
+    q_reg = reg;
+  }
+
+  while (q.room() < len + 1) {
+    if (policy == TWI_QUEUE_SHORT)
+      return false;
+    if (policy == TWI_QUEUE_DROP_OLDEST) {
+      uint8_t sreg = SREG;
+      cli();
+      q.drop(); // if only frames to keep are left, wait like TWI_QUEUE_BLOCK
+      SREG = sreg;
+    }
+    // TWI_QUEUE_BLOCK: the interrupt makes room
+  }
+
+  q.write(frame, len, flags);
+
+  uint8_t sreg = SREG;
+  cli();
+  q.commit(len);
+  bool start = !q_active;
+  q_active = true;
+  SREG = sreg;
+
+  if (start) {
+    while (TWCR & _BV(TWSTO))
+      ;
+    TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE);
+  }
+  return true;
+}
+
+bool TWIMaster::busy() { return q_active; }
+
+uint8_t TWIMaster::pending() { return q.count; }
+
+void TWIMaster::waitIdle() {
+  while (q_active)
+    ;
+  while (TWCR & _BV(TWSTO))
+    ;
+}
+
+#endif // RGBLCD_TWI_ASYNC
+
+#endif
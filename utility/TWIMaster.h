@@ -0,0 +1,64 @@
+/***************************************************
+  Minimal TWI master for AVR with an optional interrupt driven transmit queue
+
+  The interface of the synchronous part follows the Wire library, so the
+  drivers only need to swap the object they talk to.  Data is not buffered
+  but goes straight into TWDR, hence transactions can be of any length.
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#ifndef _TWIMASTER_H_
+#define _TWIMASTER_H_
+
+#include <RGBLCDShield_Fast_config.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <utility/TWIQueue.h>
+
+#ifdef RGBLCD_TWI
+
+// What to do if the transmit queue is full
+#define TWI_QUEUE_BLOCK 0       // wait until there is room
+#define TWI_QUEUE_DROP_OLDEST 1 // discard the oldest frames not to be kept
+#define TWI_QUEUE_SHORT 2       // reject the new frame
+
+class TWIMaster {
+public:
+  TWIMaster();
+
+  void begin();
+  void setClock(uint32_t clock);
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t quantity);
+  uint8_t endTransmission();
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity);
+  int read();
+
+#ifdef RGBLCD_TWI_ASYNC
+  // flags: TWI_FRAME_SETUP and TWI_FRAME_KEEP, see TWIQueue.h
+  bool queue(uint8_t address, uint8_t reg, const uint8_t *frame, uint8_t len,
+             uint8_t flags, uint8_t policy);
+  bool busy();
+  uint8_t pending();
+  void waitIdle();
+#else
+  void waitIdle() {}
+#endif
+
+private:
+  uint8_t status;
+  uint8_t twcr; // interrupt settings of Wire, restored after each transfer
+  uint8_t rxBuffer[4];
+  uint8_t rxIndex;
+  uint8_t rxLength;
+};
+
+extern TWIMaster TWIM;
+
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+/***************************************************
+  Transmit queue of the TWI master
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#include "TWIQueue.h"
+
+#ifdef RGBLCD_TWI_ASYNC
+
+void TWIQueue::write(const uint8_t *frame, uint8_t len, uint8_t flags) {
+  uint8_t h = head;
+  buf[h] = len | flags;
+  for (uint8_t i = 0; i < len; i++) {
+    h = next(h);
+    buf[h] = frame[i];
+  }
+}
+
+void TWIQueue::commit(uint8_t len) {
+  head = skip(head, len + 1);
+  count += len + 1;
+}
+
+uint8_t TWIQueue::pop(uint8_t *frame) {
+  uint8_t t = tail;
+  uint8_t len = buf[t] & TWI_FRAME_LEN;
+  for (uint8_t i = 0; i < len; i++) {
+    t = next(t);
+    frame[i] = buf[t];
+  }
+  tail = next(t);
+  count -= len + 1;
+  return len;
+}
+
+// Discards the oldest frame not marked TWI_FRAME_KEEP and moves the kept
+// frames before it up into the gap.  Returns false if all frames are to be
+// kept.  Must be called with interrupts disabled.
+bool TWIQueue::drop() {
+  uint8_t t = tail, before = 0;
+  while (before < count && (buf[t] & TWI_FRAME_KEEP)) {
+    uint8_t n = (buf[t] & TWI_FRAME_LEN) + 1;
+    t = skip(t, n);
+    before += n;
+  }
+  if (before == count)
+    return false;
+
+  uint8_t hdr = buf[t];
+  uint8_t len = hdr & TWI_FRAME_LEN;
+  uint8_t n = skip(t, len + 1);
+  uint8_t gap = len + 1;
+  if ((hdr & TWI_FRAME_SETUP) && before + len + 1 < count) {
+    if (!(buf[n] & TWI_FRAME_SETUP)) {
+      // The next frame relies on our setup byte: prepend it there.
+      uint8_t m = skip(t, len);
+      buf[m] = (buf[n] + 1) | TWI_FRAME_SETUP;
+      buf[n] = buf[next(t)];
+      gap = len;
+    }
+  } else if (hdr & TWI_FRAME_SETUP) {
+    // The frames still to come rely on it: keep the setup byte as a frame
+    // of its own, which is not dropped again.
+    uint8_t setup = buf[next(t)];
+    buf[skip(t, len - 1)] = 1 | TWI_FRAME_SETUP | TWI_FRAME_KEEP;
+    buf[skip(t, len)] = setup;
+    gap = len - 1;
+  }
+  for (uint8_t i = before; i-- > 0;)
+    buf[skip(tail, i + gap)] = buf[skip(tail, i)];
+  tail = skip(tail, gap);
+  count -= gap;
+  return true;
+}
+
+void TWIQueue::clear() {
+  tail = head;
+  count = 0;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/***************************************************
+  Transmit queue of the TWI master
+
+  Frames of [header][data...] in a ring buffer.  A frame is sent completely
+  or not at all, so the interrupt copies the oldest one out before it
+  starts it and all frames in the buffer are still unsent.  The header
+  holds the length and two flags: TWI_FRAME_SETUP marks a frame whose first
+  byte only sets up the lines (e.g. RS of the LCD) for the following ones,
+  TWI_FRAME_KEEP a frame which must not be dropped, like an LCD command.
+
+  Written by Bastian Maerkisch.  BSD license.
+ ****************************************************/
+
+#ifndef _TWIQUEUE_H_
+#define _TWIQUEUE_H_
+
+#include <RGBLCDShield_Fast_config.h>
+#include <inttypes.h>
+
+#ifdef RGBLCD_TWI_ASYNC
+
+#if RGBLCD_QUEUE_SIZE < 16 || RGBLCD_QUEUE_SIZE > 255
+#error "RGBLCD_QUEUE_SIZE must be between 16 and 255"
+#endif
+
+#define TWI_FRAME_SETUP 0x80 // first byte only sets up the lines
+#define TWI_FRAME_KEEP 0x40  // never dropped
+#define TWI_FRAME_LEN 0x3f   // length bits of the header
+
+#define TWI_FRAME_MAX 6 // longest frame pop() returns
+
+class TWIQueue {
+public:
+  TWIQueue() : count(0), head(0), tail(0) {}
+
+  uint8_t room() const { return RGBLCD_QUEUE_SIZE - count; }
+  // Copies a frame behind the last one, room() must be len + 1 or more.
+  // It only becomes visible with commit(), so the interrupt can run.
+  void write(const uint8_t *frame, uint8_t len, uint8_t flags);
+  // Appends the frame of write().  Must be called with interrupts disabled.
+  void commit(uint8_t len);
+  // Removes the oldest frame and returns its length.
+  uint8_t pop(uint8_t *frame);
+  bool drop();
+  void clear();
+
+  volatile uint8_t count; // bytes in buf
+
+private:
+  static uint8_t next(uint8_t i) {
+    return (i + 1 < RGBLCD_QUEUE_SIZE) ? i + 1 : 0;
+  }
+  static uint8_t skip(uint8_t i, uint8_t n) {
+    uint16_t j = i + n;
+    return (j < RGBLCD_QUEUE_SIZE) ? j : j - RGBLCD_QUEUE_SIZE;
+  }
+
+  uint8_t buf[RGBLCD_QUEUE_SIZE];
+  volatile uint8_t head; // next free byte
+  volatile uint8_t tail; // header of the oldest frame
+};
+
+#endif
+
+#endif